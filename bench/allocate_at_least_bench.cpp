@@ -0,0 +1,127 @@
+/*
+    Shows how many reallocations devector saves by keeping the slack an allocator reports through
+    allocate_at_least. Many small devectors are filled with push_back and push_front, once with
+    allocators that only have allocate and once with the same allocators reporting their slack.
+
+    g++ -std=c++11 -O2 -I.. allocate_at_least_bench.cpp -o allocate_at_least_bench
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__)
+    #include <malloc.h>
+#endif
+
+#include "devector.h"
+
+
+static std::size_t allocations = 0;
+
+// Where the slack comes from. jemalloc style size classes have four steps per doubling, glibc
+// reports its own through malloc_usable_size.
+enum class size_classes { jemalloc, glibc };
+
+std::size_t round_to_class(std::size_t bytes) {
+    if (bytes <= 16) return 16;
+    std::size_t pow = 16;
+    while (pow * 2 < bytes) pow *= 2;
+    std::size_t step = pow / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+template<class T, size_classes Classes>
+struct counting_allocator {
+    typedef T value_type;
+
+    counting_allocator() = default;
+    template<class U> counting_allocator(const counting_allocator<U, Classes>&) { }
+
+    template<class U> struct rebind { typedef counting_allocator<U, Classes> other; };
+
+    T* allocate(std::size_t n) { return raw_allocate(n).first; }
+    void deallocate(T* p, std::size_t) { std::free(p); }
+
+    bool operator==(const counting_allocator&) const { return true; }
+    bool operator!=(const counting_allocator&) const { return false; }
+
+protected:
+    std::pair<T*, std::size_t> raw_allocate(std::size_t n) {
+        ++allocations;
+        std::size_t bytes = n * sizeof(T);
+        if (Classes == size_classes::jemalloc) bytes = round_to_class(bytes);
+        T* p = static_cast<T*>(std::malloc(bytes));
+        if (!p) throw std::bad_alloc();
+
+#if defined(__GLIBC__)
+        if (Classes == size_classes::glibc) bytes = malloc_usable_size(p);
+#endif
+
+        return std::make_pair(p, bytes / sizeof(T));
+    }
+};
+
+// The same allocator, but it reports the size class it rounded up to.
+template<class T, size_classes Classes>
+struct at_least_allocator : counting_allocator<T, Classes> {
+    struct result { T* ptr; std::size_t count; };
+
+    at_least_allocator() = default;
+    template<class U> at_least_allocator(const at_least_allocator<U, Classes>&) { }
+
+    template<class U> struct rebind { typedef at_least_allocator<U, Classes> other; };
+
+    result allocate_at_least(std::size_t n) {
+        std::pair<T*, std::size_t> r = this->raw_allocate(n);
+        return {r.first, r.second};
+    }
+};
+
+template<class Allocator>
+double run(const std::vector<int>& sizes, std::size_t& num_allocations, long long& checksum) {
+    allocations = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int n : sizes) {
+        devector<int, Allocator> d;
+        for (int i = 0; i < n; ++i) {
+            if (i % 4 == 0) d.push_front(i);
+            else            d.push_back(i);
+        }
+
+        checksum += d.front() + d.back();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    num_allocations = allocations;
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template<size_classes Classes>
+void bench(const char* name, const std::vector<int>& sizes) {
+    std::size_t exact_allocs, at_least_allocs;
+    long long checksum = 0;
+    double exact = run<counting_allocator<int, Classes>>(sizes, exact_allocs, checksum);
+    double at_least = run<at_least_allocator<int, Classes>>(sizes, at_least_allocs, checksum);
+    std::printf("%-10s %12zu %12zu %12.2f %12.2f   (%lld)\n",
+                name, exact_allocs, at_least_allocs, exact, at_least, checksum);
+}
+
+int main() {
+    std::mt19937 rng(42);
+    std::vector<int> sizes(200000);
+    for (int& n : sizes) n = 1 + rng() % 200;
+
+    std::printf("%-10s %12s %12s %12s %12s\n",
+                "classes", "allocate", "at_least", "allocate ms", "at_least ms");
+    bench<size_classes::jemalloc>("jemalloc", sizes);
+#if defined(__GLIBC__)
+    bench<size_classes::glibc>("glibc", sizes);
+#endif
+}
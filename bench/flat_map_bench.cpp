@@ -0,0 +1,81 @@
+/*
+    Compares flat_map (backed by devector) against the same sorted layout backed by std::vector and
+    against std::map, for random keys and for append-mostly keys that are nearly sorted.
+
+    g++ -std=c++11 -O2 -I.. flat_map_bench.cpp -o flat_map_bench
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "flat_map.h"
+
+
+// Minimal sorted vector map, the usual way a flat map is written.
+class vector_flat_map {
+public:
+    int& operator[](std::uint32_t key) {
+        auto it = std::lower_bound(seq.begin(), seq.end(), key,
+            [](const std::pair<std::uint32_t, int>& p, std::uint32_t k) { return p.first < k; });
+        if (it == seq.end() || it->first != key) it = seq.insert(it, std::make_pair(key, 0));
+        return it->second;
+    }
+
+private:
+    std::vector<std::pair<std::uint32_t, int>> seq;
+};
+
+
+// Every key is random.
+std::vector<std::uint32_t> random_keys(std::size_t n) {
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> keys(n);
+    for (auto& k : keys) k = rng();
+    return keys;
+}
+
+// Keys mostly increase, one in sixteen lands somewhere in the last 1% of what came before.
+std::vector<std::uint32_t> append_mostly_keys(std::size_t n) {
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint32_t k = std::uint32_t(i) * 16;
+        if (rng() % 16 == 0) k -= rng() % (k / 100 + 1);
+        keys[i] = k;
+    }
+    return keys;
+}
+
+template<class Map>
+double run(const std::vector<std::uint32_t>& keys, long long& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    Map m;
+    for (std::uint32_t k : keys) ++m[k];
+    for (std::size_t i = 0; i < keys.size(); i += 7) checksum += m[keys[i]];
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void bench(const char* name, const std::vector<std::uint32_t>& keys) {
+    long long checksum = 0;
+    double devec = run<flat_map<std::uint32_t, int>>(keys, checksum);
+    double vec = run<vector_flat_map>(keys, checksum);
+    double tree = run<std::map<std::uint32_t, int>>(keys, checksum);
+    std::printf("%-14s %8zu %12.2f %12.2f %12.2f   (%lld)\n",
+                name, keys.size(), devec, vec, tree, checksum);
+}
+
+int main() {
+    std::printf("%-14s %8s %12s %12s %12s\n", "keys", "n", "flat_map ms", "vector ms",
+                "std::map ms");
+    for (std::size_t n : {1000, 10000, 100000}) {
+        bench("random", random_keys(n));
+        bench("append-mostly", append_mostly_keys(n));
+    }
+}
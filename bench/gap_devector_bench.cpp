@@ -0,0 +1,52 @@
+/*
+    Compares gap_devector against devector::insert/erase for clustered edits: a cursor jumps to a
+    random position now and then and a burst of characters is typed or deleted around it.
+
+    g++ -std=c++11 -O2 -I.. gap_devector_bench.cpp -o gap_devector_bench
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+
+#include "devector.h"
+#include "gap_devector.h"
+
+
+template<class Container>
+double run(std::size_t initial, std::size_t jumps, std::size_t burst, long long& checksum) {
+    std::mt19937 rng(42);
+    Container text;
+    text.insert(text.end(), initial, 'x');
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t j = 0; j < jumps; ++j) {
+        std::size_t cursor = rng() % (text.size() + 1);
+
+        // Type a burst, then backspace over half of it.
+        for (std::size_t k = 0; k < burst; ++k) {
+            text.insert(text.begin() + cursor++, char('a' + k % 26));
+        }
+
+        for (std::size_t k = 0; k < burst / 2; ++k) text.erase(text.begin() + --cursor);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < text.size(); i += 97) checksum += text[i];
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    std::printf("%10s %8s %16s %14s\n", "initial", "burst", "gap_devector ms", "devector ms");
+    for (std::size_t initial : {10000, 100000, 1000000}) {
+        for (std::size_t burst : {1, 16, 256}) {
+            long long checksum = 0;
+            std::size_t jumps = 1000000 / burst / 4;
+            double gap = run<gap_devector<char>>(initial, jumps, burst, checksum);
+            double devec = run<devector<char>>(initial, jumps, burst, checksum);
+            std::printf("%10zu %8zu %16.2f %14.2f   (%lld)\n",
+                        initial, burst, gap, devec, checksum);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+    Compares scans and random accesses over a large devector using std::allocator,
+    huge_page_allocator, and huge_page_allocator with options().align_cursor set. Each devector is
+    used like a queue that consumed a few elements at the front and then grew at the back, so the
+    first element is not aligned unless asked for.
+
+    g++ -std=c++11 -O2 -I.. huge_page_bench.cpp -o huge_page_bench
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "devector.h"
+#include "huge_page_allocator.h"
+
+
+const std::size_t num_elements = std::size_t(1) << 24;
+const int num_scans = 10;
+
+template<class Allocator>
+void bench(const char* name, const Allocator& alloc, const std::vector<std::uint32_t>& indices) {
+    devector<double, Allocator> d(alloc);
+    for (std::size_t i = 0; i < num_elements + 3; ++i) d.push_back(double(i));
+    for (int i = 0; i < 3; ++i) d.pop_front();
+    d.reserve(d.capacity() + num_elements / 4);
+
+    // Offset of the first element from a cache line.
+    unsigned offset = unsigned(reinterpret_cast<std::uintptr_t>(std::addressof(d[0])) % 64);
+
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (int s = 0; s < num_scans; ++s) {
+        for (double x : d) sum += x;
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (std::uint32_t i : indices) sum += d[i];
+    auto end = std::chrono::steady_clock::now();
+
+    std::printf("%-22s %8u %10.2f %10.2f   (%g)\n", name, offset,
+                std::chrono::duration<double, std::milli>(mid - start).count() / num_scans,
+                std::chrono::duration<double, std::milli>(end - mid).count(), sum);
+}
+
+int main() {
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> indices(num_elements);
+    for (std::uint32_t& i : indices) i = std::uint32_t(rng() % num_elements);
+
+    huge_page_options aligned;
+    aligned.align_cursor = true;
+
+    std::printf("%-22s %8s %10s %10s\n", "allocator", "offset", "scan ms", "random ms");
+    bench("std::allocator", std::allocator<double>(), indices);
+    bench("huge_page_allocator", huge_page_allocator<double>(), indices);
+    bench("  with align_cursor", huge_page_allocator<double>(aligned), indices);
+}
@@ -21,11 +21,20 @@
 
 // TODO: Include what you use.
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <utility>
 
 
+// In C++20 memory allocated during constant evaluation may be used as long as it is freed again
+// before the evaluation ends, which makes devector usable in constant expressions.
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L
+    #define DEVECTOR_CONSTEXPR constexpr
+#else
+    #define DEVECTOR_CONSTEXPR
+#endif
+
 
 // There is an issue with std::swap. It uses a recursive noexcept declaration for multidimensional
 // arrays, but those do not work. This code defines detail::is_nothrow_swappable to solve that.
@@ -104,14 +113,183 @@ namespace detail {
     constexpr move_if_noexcept_iterator<Iterator> make_move_if_noexcept_iterator(Iterator i) {
         return move_if_noexcept_iterator<Iterator>(i);
     }
+
+    // Memory returned by allocate_at_least, count is the number of elements that fit in it.
+    template<class Allocator>
+    struct allocation_result {
+        typename std::allocator_traits<Allocator>::pointer ptr;
+        typename std::allocator_traits<Allocator>::size_type count;
+    };
+
+    // Allocators often hand out more memory than requested because of size classes. An allocator
+    // can report this with a member allocate_at_least(n) returning an object with ptr and count
+    // members, like C++23's std::allocator. The member is called directly, so its result does not
+    // have to be a std::allocation_result. Otherwise allocator_traits::allocate_at_least is used
+    // where the standard library has it, or exactly n elements are allocated.
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR auto allocate_at_least_impl(
+        Allocator& alloc, typename std::allocator_traits<Allocator>::size_type n, int
+    ) -> decltype(alloc.allocate_at_least(n).count, allocation_result<Allocator>()) {
+        auto result = alloc.allocate_at_least(n);
+        return {result.ptr, result.count};
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR allocation_result<Allocator> allocate_at_least_impl(
+        Allocator& alloc, typename std::allocator_traits<Allocator>::size_type n, long
+    ) {
+#if defined(__cpp_lib_allocate_at_least) && __cpp_lib_allocate_at_least >= 202302L
+        auto result = std::allocator_traits<Allocator>::allocate_at_least(alloc, n);
+        return {result.ptr, result.count};
+#else
+        return {std::allocator_traits<Allocator>::allocate(alloc, n), n};
+#endif
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR allocation_result<Allocator> allocate_at_least(
+        Allocator& alloc, typename std::allocator_traits<Allocator>::size_type n
+    ) {
+        return allocate_at_least_impl(alloc, n, 0);
+    }
+
+    // An allocator that rounds allocations up can report what allocate_at_least(n) would return
+    // with a member good_size(n), without allocating. This lets reclaim skip reallocations that
+    // would not lower the capacity.
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR auto good_size_impl(
+        const Allocator& alloc, typename std::allocator_traits<Allocator>::size_type n, int
+    ) -> decltype(alloc.good_size(n)) {
+        return alloc.good_size(n);
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR typename std::allocator_traits<Allocator>::size_type good_size_impl(
+        const Allocator&, typename std::allocator_traits<Allocator>::size_type n, long
+    ) {
+        return n;
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR typename std::allocator_traits<Allocator>::size_type good_size(
+        const Allocator& alloc, typename std::allocator_traits<Allocator>::size_type n
+    ) {
+        return good_size_impl(alloc, n, 0);
+    }
+
+    // An allocator that aligns its storage can have devector align begin_cursor as well, by
+    // returning the alignment in elements from a member cursor_alignment(). This only holds
+    // directly after a reallocation, until the next push_front or pop_front.
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR auto cursor_alignment_impl(
+        const Allocator& alloc, int
+    ) -> decltype(alloc.cursor_alignment()) {
+        return alloc.cursor_alignment();
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR typename std::allocator_traits<Allocator>::size_type cursor_alignment_impl(
+        const Allocator&, long
+    ) {
+        return 1;
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR typename std::allocator_traits<Allocator>::size_type cursor_alignment(
+        const Allocator& alloc
+    ) {
+        return cursor_alignment_impl(alloc, 0);
+    }
+
+    // An allocator that can release the end of an allocation without moving it, for example by
+    // unmapping whole pages, can have a member shrink_in_place(p, count, n). It shrinks the
+    // allocation at p of count elements to no less than n elements and returns the new count,
+    // which deallocate then receives. If it can't, it returns count.
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR auto shrink_in_place_impl(
+        Allocator& alloc, typename std::allocator_traits<Allocator>::pointer p,
+        typename std::allocator_traits<Allocator>::size_type count,
+        typename std::allocator_traits<Allocator>::size_type n, int
+    ) -> decltype(alloc.shrink_in_place(p, count, n)) {
+        return alloc.shrink_in_place(p, count, n);
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR typename std::allocator_traits<Allocator>::size_type shrink_in_place_impl(
+        Allocator&, typename std::allocator_traits<Allocator>::pointer,
+        typename std::allocator_traits<Allocator>::size_type count,
+        typename std::allocator_traits<Allocator>::size_type, long
+    ) {
+        return count;
+    }
+
+    template<class Allocator>
+    DEVECTOR_CONSTEXPR typename std::allocator_traits<Allocator>::size_type shrink_in_place(
+        Allocator& alloc, typename std::allocator_traits<Allocator>::pointer p,
+        typename std::allocator_traits<Allocator>::size_type count,
+        typename std::allocator_traits<Allocator>::size_type n
+    ) {
+        return shrink_in_place_impl(alloc, p, count, n, 0);
+    }
+
+    // Whether Allocator has shrink_in_place, so devector only moves elements to the start of the
+    // storage for it when the allocator may then release the rest.
+    template<class Allocator>
+    auto has_shrink_in_place_impl(int) -> decltype(
+        std::declval<Allocator&>().shrink_in_place(
+            std::declval<typename std::allocator_traits<Allocator>::pointer>(),
+            std::declval<typename std::allocator_traits<Allocator>::size_type>(),
+            std::declval<typename std::allocator_traits<Allocator>::size_type>()),
+        std::true_type());
+
+    template<class Allocator>
+    std::false_type has_shrink_in_place_impl(long);
+
+    template<class Allocator>
+    using has_shrink_in_place = decltype(has_shrink_in_place_impl<Allocator>(0));
 }
 
 
-template<class T, class Allocator = std::allocator<T>>
+// Reclaim policies decide when devector gives free space back to the allocator on its own, after
+// elements have been removed. A policy has a static member function
+// should_reclaim(size, capacity) that is called after every removal.
+
+// Never reclaims, memory is only released by shrink_to_fit, shrink_front and shrink_back. This is
+// the default and costs nothing.
+struct no_reclaim {
+    static constexpr bool enabled = false;
+
+    template<class SizeType>
+    static constexpr bool should_reclaim(SizeType, SizeType) noexcept { return false; }
+};
+
+// Reclaims once more than Num/Den of the capacity is free, but not below 16 elements of capacity.
+// A reclaim leaves size() / 3 free space on each end, like growing does, so it takes many
+// removals before the next reclaim happens. The default of 3/4 is like halving a vector when
+// it is a quarter full.
+template<std::size_t Num = 3, std::size_t Den = 4>
+struct reclaim_slack {
+    static_assert(Num < Den, "reclaim_slack: free fraction must be less than one");
+
+    static constexpr bool enabled = true;
+
+    template<class SizeType>
+    static constexpr bool should_reclaim(SizeType size, SizeType capacity) noexcept {
+        // Multiply rather than divide, so the fraction is exact. Very large capacities would
+        // overflow, for those the rounding of the division does not matter.
+        return capacity >= 16 &&
+               (capacity <= std::numeric_limits<SizeType>::max() / Den
+                    ? (capacity - size) * Den > capacity * Num
+                    : capacity - size > capacity / Den * Num);
+    }
+};
+
+
+template<class T, class Allocator = std::allocator<T>, class ReclaimPolicy = no_reclaim>
 class devector {
 private:
     typedef std::allocator_traits<Allocator> alloc_traits;
-    typedef devector<T, Allocator> V;
+    typedef devector<T, Allocator, ReclaimPolicy> V;
 
 public:
     // Typedefs.
@@ -129,14 +307,17 @@ public:
     typedef std::reverse_iterator<const_iterator>  const_reverse_iterator;
 
     // Construct/copy/destroy.
-    ~devector() noexcept { destruct(); }
+    DEVECTOR_CONSTEXPR ~devector() noexcept { destruct(); }
 
+    DEVECTOR_CONSTEXPR
     devector() noexcept(std::is_nothrow_default_constructible<Allocator>::value) : impl() {
         impl.null();
     }
 
+    DEVECTOR_CONSTEXPR
     explicit devector(const Allocator& alloc) noexcept : impl(alloc) { impl.null(); }
 
+    DEVECTOR_CONSTEXPR
     explicit devector(size_type n, const Allocator& alloc = Allocator()) : impl(alloc) {
         impl.begin_storage = impl.begin_cursor = alloc_traits::allocate(impl, n);
         impl.end_storage = impl.end_cursor = impl.begin_storage + n;
@@ -144,6 +325,7 @@ public:
         catch (...) { deallocate(); throw; }
     }
 
+    DEVECTOR_CONSTEXPR
     devector(size_type n, const T& value, const Allocator& alloc = Allocator()) : impl(alloc) {
         impl.begin_storage = impl.begin_cursor = alloc_traits::allocate(impl, n);
         impl.end_storage = impl.end_cursor = impl.begin_storage + n;
@@ -152,26 +334,27 @@ public:
     }
 
     template<class InputIterator>
+    DEVECTOR_CONSTEXPR
     devector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator())
     : impl(alloc) {
         init_range(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
     }
 
-    devector(const V& other)
+    DEVECTOR_CONSTEXPR devector(const V& other)
     : impl(alloc_traits::select_on_container_copy_construction(other.impl.alloc())) {
         init_range(other.begin(), other.end(), std::random_access_iterator_tag());
     }
 
-    devector(const V& other, const Allocator& alloc) : impl(alloc) {
+    DEVECTOR_CONSTEXPR devector(const V& other, const Allocator& alloc) : impl(alloc) {
         init_range(other.begin(), other.end(), std::random_access_iterator_tag());
     }
 
-    devector(V&& other) noexcept : impl(std::move(other.impl.alloc())) {
+    DEVECTOR_CONSTEXPR devector(V&& other) noexcept : impl(std::move(other.impl.alloc())) {
         impl.storage() = std::move(other.impl.storage());
         other.impl.null();
     }
 
-    devector(V&& other, const Allocator& alloc) : impl(alloc) {
+    DEVECTOR_CONSTEXPR devector(V&& other, const Allocator& alloc) : impl(alloc) {
         if (impl.alloc() == other.impl.alloc()) {
             impl.storage() = std::move(other.impl.storage());
         } else {
@@ -184,11 +367,12 @@ public:
         other.impl.null();
     }
 
+    DEVECTOR_CONSTEXPR
     devector(std::initializer_list<T> il, const Allocator& alloc = Allocator()) : impl(alloc) {
         init_range(il.begin(), il.end(), std::random_access_iterator_tag());
     }
 
-    V& operator=(const V& other) {
+    DEVECTOR_CONSTEXPR V& operator=(const V& other) {
         if (this != &other) {
             copy_assign_propagate_dispatcher(
                 other,
@@ -201,6 +385,7 @@ public:
         return *this;
     }
 
+    DEVECTOR_CONSTEXPR
     V& operator=(V&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value) {
         if (this != &other) {
             move_assign_propagate_dispatcher(
@@ -214,10 +399,10 @@ public:
         return *this;
     }
 
-    V& operator=(std::initializer_list<T> il) { assign(il); return *this; }
+    DEVECTOR_CONSTEXPR V& operator=(std::initializer_list<T> il) { assign(il); return *this; }
 
     template<class InputIterator>
-    typename std::enable_if<
+    DEVECTOR_CONSTEXPR typename std::enable_if<
         std::is_base_of<
             std::input_iterator_tag,
             typename std::iterator_traits<InputIterator>::iterator_category
@@ -227,196 +412,268 @@ public:
                      typename std::iterator_traits<InputIterator>::iterator_category());
     }
 
-    void assign(size_type n, const T& t) {
+    DEVECTOR_CONSTEXPR void assign(size_type n, const T& t) {
         reserve(n);
-        while (size() > n) pop_back();
+        while (size() > n) destroy_back();
         for (iterator it = begin(); it != end(); ++it) *it = t;
         while (size() < n) push_back(t);
     }
 
-    void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+    DEVECTOR_CONSTEXPR void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
 
-    allocator_type get_allocator() const noexcept { return impl; }
+    DEVECTOR_CONSTEXPR allocator_type get_allocator() const noexcept { return impl; }
 
     // Iterators.
+    DEVECTOR_CONSTEXPR
     iterator               begin()         noexcept { return iterator(impl.begin_cursor); }
+    DEVECTOR_CONSTEXPR
     const_iterator         begin()   const noexcept { return iterator(impl.begin_cursor); }
+    DEVECTOR_CONSTEXPR
     iterator               end()           noexcept { return iterator(impl.end_cursor); }
+    DEVECTOR_CONSTEXPR
     const_iterator         end()     const noexcept { return iterator(impl.end_cursor); }
 
+    DEVECTOR_CONSTEXPR
     reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+    DEVECTOR_CONSTEXPR
     const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    DEVECTOR_CONSTEXPR
     reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+    DEVECTOR_CONSTEXPR
     const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
 
-    const_iterator         cbegin()  const noexcept { return begin(); }
-    const_iterator         cend()    const noexcept { return end(); }
-    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
-    const_reverse_iterator crend()   const noexcept { return rend(); }
+    DEVECTOR_CONSTEXPR const_iterator         cbegin()  const noexcept { return begin(); }
+    DEVECTOR_CONSTEXPR const_iterator         cend()    const noexcept { return end(); }
+    DEVECTOR_CONSTEXPR const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    DEVECTOR_CONSTEXPR const_reverse_iterator crend()   const noexcept { return rend(); }
 
     // Capacity.
-    size_type max_size()       const noexcept { return impl.max_size(); }
+    DEVECTOR_CONSTEXPR
+    size_type max_size()       const noexcept { return alloc_traits::max_size(impl); }
+    DEVECTOR_CONSTEXPR
     size_type size()           const noexcept { return impl.end_cursor  - impl.begin_cursor; }
+    DEVECTOR_CONSTEXPR
     size_type capacity()       const noexcept { return impl.end_storage - impl.begin_storage; }
+    DEVECTOR_CONSTEXPR
     size_type capacity_front() const noexcept { return impl.end_cursor  - impl.begin_storage; }
+    DEVECTOR_CONSTEXPR
     size_type capacity_back()  const noexcept { return impl.end_storage - impl.begin_cursor; }
 
-    void resize(size_type n)                   { resize_back_impl(n);     }
-    void resize(size_type n, const T& t)       { resize_back_impl(n, t);  }
-    void resize_back(size_type n)              { resize_back_impl(n);     }
-    void resize_back(size_type n, const T& t)  { resize_back_impl(n, t);  }
-    void resize_front(size_type n)             { resize_front_impl(n);    }
-    void resize_front(size_type n, const T& t) { resize_front_impl(n, t); }
+    DEVECTOR_CONSTEXPR void resize(size_type n)                   { resize_back_impl(n);     }
+    DEVECTOR_CONSTEXPR void resize(size_type n, const T& t)       { resize_back_impl(n, t);  }
+    DEVECTOR_CONSTEXPR void resize_back(size_type n)              { resize_back_impl(n);     }
+    DEVECTOR_CONSTEXPR void resize_back(size_type n, const T& t)  { resize_back_impl(n, t);  }
+    DEVECTOR_CONSTEXPR void resize_front(size_type n)             { resize_front_impl(n);    }
+    DEVECTOR_CONSTEXPR void resize_front(size_type n, const T& t) { resize_front_impl(n, t); }
 
-    void reserve(size_type n) { reserve_back(n); }
+    DEVECTOR_CONSTEXPR void reserve(size_type n) { reserve_back(n); }
 
-    void reserve(size_type new_front, size_type new_back) {
+    DEVECTOR_CONSTEXPR void reserve(size_type new_front, size_type new_back) {
         if (new_front > max_size() || new_back > max_size()) throw std::length_error("devector");
         if (capacity_front() >= new_front && capacity_back() >= new_back) return;
 
-        reallocate(new_front - size(), new_back - size());
+        // Never shrink the side that already has enough capacity.
+        reallocate(std::max<size_type>(new_front, capacity_front()) - size(),
+                   std::max<size_type>(new_back, capacity_back()) - size(),
+                   capacity_back() >= new_back);
     }
 
-    void reserve_front(size_type n) {
+    DEVECTOR_CONSTEXPR void reserve_front(size_type n) {
         if (n > max_size()) throw std::length_error("devector");
         if (capacity_front() >= n) return;
 
-        reallocate(n - size(), impl.end_storage - impl.end_cursor);
+        reallocate(n - size(), impl.end_storage - impl.end_cursor, true);
     }
 
-    void reserve_back(size_type n) {
+    DEVECTOR_CONSTEXPR void reserve_back(size_type n) {
         if (n > max_size()) throw std::length_error("devector");
         if (capacity_back() >= n) return;
 
-        reallocate(impl.begin_cursor - impl.begin_storage, n - size());
+        reallocate(impl.begin_cursor - impl.begin_storage, n - size(), false);
     }
 
-    void shrink_to_fit() {
+    DEVECTOR_CONSTEXPR void shrink_to_fit() {
         if (capacity() <= size()) return; 
 
-        V(detail::make_move_if_noexcept_iterator(begin()),
-          detail::make_move_if_noexcept_iterator(end()),
-          get_allocator()).swap(*this);
+        if (empty()) {
+            deallocate();
+            impl.null();
+        } else if (!shrink_in_place(false, 0)) {
+            reallocate(0, 0, false);
+        }
+    }
+
+    // Release only the free space at the front or back. Like shrink_to_fit, this is a non-binding
+    // request and invalidates all iterators and references if it reallocates.
+    DEVECTOR_CONSTEXPR void shrink_front() {
+        if (impl.begin_cursor == impl.begin_storage) return;
+
+        size_type space_back = impl.end_storage - impl.end_cursor;
+        if (empty() && space_back == 0) shrink_to_fit();
+        else if (!shrink_in_place(false, space_back)) reallocate(0, space_back, false);
     }
 
-    bool empty() const noexcept { return impl.begin_cursor == impl.end_cursor; }
+    DEVECTOR_CONSTEXPR void shrink_back() {
+        if (impl.end_cursor == impl.end_storage) return;
+
+        size_type space_front = impl.begin_cursor - impl.begin_storage;
+        if (empty() && space_front == 0) shrink_to_fit();
+        else if (!shrink_in_place(true, 0)) reallocate(space_front, 0, true);
+    }
+
+    DEVECTOR_CONSTEXPR bool empty() const noexcept { return impl.begin_cursor == impl.end_cursor; }
 
     // Indexing.
+    DEVECTOR_CONSTEXPR
     reference       operator[](size_type i)       noexcept { return impl.begin_cursor[i]; }
+    DEVECTOR_CONSTEXPR
     const_reference operator[](size_type i) const noexcept { return impl.begin_cursor[i]; }
 
-    reference at(size_type i) {
+    DEVECTOR_CONSTEXPR reference at(size_type i) {
         if (i >= size()) throw std::out_of_range("devector");
         return (*this)[i];
     }
 
-    const_reference at(size_type i) const {
+    DEVECTOR_CONSTEXPR const_reference at(size_type i) const {
         if (i >= size()) throw std::out_of_range("devector");
         return (*this)[i];
     }
 
-    reference         front()       noexcept { return *begin(); }
-    const_reference   front() const noexcept { return *begin(); }
-    reference         back()        noexcept { return *(end() - 1); }
-    const_reference   back()  const noexcept { return *(end() - 1); }
-    T*                data()        noexcept { return std::addressof(front()); }
-    const T*          data()  const noexcept { return std::addressof(front()); }
+    DEVECTOR_CONSTEXPR reference         front()       noexcept { return *begin(); }
+    DEVECTOR_CONSTEXPR const_reference   front() const noexcept { return *begin(); }
+    DEVECTOR_CONSTEXPR reference         back()        noexcept { return *(end() - 1); }
+    DEVECTOR_CONSTEXPR const_reference   back()  const noexcept { return *(end() - 1); }
+    DEVECTOR_CONSTEXPR T*                data()        noexcept { return std::addressof(front()); }
+    DEVECTOR_CONSTEXPR const T*          data()  const noexcept { return std::addressof(front()); }
 
     // Modifiers.
-    void push_front(const T& x) { emplace_front(x); }
-    void push_front(T&& x)      { emplace_front(std::move(x)); }
-    void push_back(const T& x)  { emplace_back(x); }
-    void push_back(T&& x)       { emplace_back(std::move(x)); }
+    DEVECTOR_CONSTEXPR void push_front(const T& x) { emplace_front(x); }
+    DEVECTOR_CONSTEXPR void push_front(T&& x)      { emplace_front(std::move(x)); }
+    DEVECTOR_CONSTEXPR void push_back(const T& x)  { emplace_back(x); }
+    DEVECTOR_CONSTEXPR void push_back(T&& x)       { emplace_back(std::move(x)); }
 
-    void pop_front() noexcept { alloc_traits::destroy(impl, std::addressof(*impl.begin_cursor++)); }
-    void pop_back()  noexcept { alloc_traits::destroy(impl, std::addressof(*--impl.end_cursor));   }
+    DEVECTOR_CONSTEXPR void pop_front() noexcept { destroy_front(); reclaim(true);  }
+    DEVECTOR_CONSTEXPR void pop_back()  noexcept { destroy_back();  reclaim(false); }
 
     template<class... Args>
-    void emplace_front(Args&&... args) {
+    DEVECTOR_CONSTEXPR void emplace_front(Args&&... args) {
         assure_space_front(1);
         alloc_traits::construct(impl, std::addressof(*(begin() - 1)), std::forward<Args>(args)...);
         --impl.begin_cursor; // We do this after constructing for strong exception safety.
     }
 
     template<class... Args>
-    void emplace_back(Args&&... args) {
+    DEVECTOR_CONSTEXPR void emplace_back(Args&&... args) {
         assure_space_back(1);
         alloc_traits::construct(impl, std::addressof(*end()), std::forward<Args>(args)...);
         ++impl.end_cursor; // We do this after constructing for strong exception safety.
     }
 
-    // CORRECT MARKER
-    
     template<class... Args>
-    iterator emplace(const_iterator position, Args&&... args) {
-        // TODO: move to unitialized memory broken
-        // TODO: strong exception guarantee
+    DEVECTOR_CONSTEXPR iterator emplace(const_iterator position, Args&&... args) {
         difference_type dist_front = position - begin();
         difference_type dist_back = end() - position;
 
-        if (dist_front < dist_back) {
-            // TODO: do not move data twice
-            //if (impl.begin_cursor == impl.begin_storage) req_storage_front();
+        // Construct first, args might alias an element of the devector.
+        T tmp(std::forward<Args>(args)...);
 
+        // Only the elements on the shorter side of position get shifted.
+        if (dist_front < dist_back) {
             if (dist_front == 0) {
-                alloc_traits::construct(impl, std::addressof(*(begin() - 1)),
-                                        std::forward<Args>(args)...);
-            } else {
-                T tmp(std::forward<Args>(args)...);
-
-                try {
-                    alloc_traits::construct(impl, std::addressof(*(begin() - 1)),
-                                            std::move_if_noexcept(front()));
-                } catch (...) {
-                    alloc_traits::destroy(impl, std::addressof(*(begin() - 1)));
-                    throw;
-                }
-
-
+                emplace_front(std::move(tmp));
+                return begin();
             }
 
+            assure_space_front(1);
+            alloc_traits::construct(impl, std::addressof(*(begin() - 1)),
+                                    std::move_if_noexcept(front()));
             --impl.begin_cursor;
+            std::move(begin() + 2, begin() + dist_front + 1, begin() + 1);
+            begin()[dist_front] = std::move(tmp);
         } else {
+            if (dist_back == 0) {
+                emplace_back(std::move(tmp));
+                return end() - 1;
+            }
+
+            assure_space_back(1);
+            alloc_traits::construct(impl, std::addressof(*end()), std::move_if_noexcept(back()));
+            ++impl.end_cursor;
+            std::move_backward(end() - dist_back - 1, end() - 2, end() - 1);
+            begin()[dist_front] = std::move(tmp);
         }
 
-        // const_iterator to iterator
         return begin() + dist_front;
     }
 
+    DEVECTOR_CONSTEXPR
     iterator insert(const_iterator position, const T& t) { return emplace(position, t); }
+    DEVECTOR_CONSTEXPR
     iterator insert(const_iterator position, T&& t) { return emplace(position, std::move(t)); }
-    iterator insert(const_iterator position, size_type n, const T& t);
 
-    iterator insert(const_iterator position, std::initializer_list<T> il) {
+    DEVECTOR_CONSTEXPR iterator insert(const_iterator position, size_type n, const T& t) {
+        difference_type dist_front = position - begin();
+        if (n == 0) return begin() + dist_front;
+
+        // Copy first, t might alias an element of the devector.
+        T tmp(t);
+        if (dist_front < end() - position) {
+            assure_space_front(n);
+            insert_front_impl(dist_front, [&]() { emplace_front(tmp); return --n > 0; });
+        } else {
+            assure_space_back(n);
+            insert_back_impl(dist_front, [&]() { emplace_back(tmp); return --n > 0; });
+        }
+
+        return begin() + dist_front;
+    }
+
+    DEVECTOR_CONSTEXPR iterator insert(const_iterator position, std::initializer_list<T> il) {
         return insert(position, il.begin(), il.end());
     }
     
     template<class InputIterator>
-    typename std::enable_if<
+    DEVECTOR_CONSTEXPR typename std::enable_if<
         std::is_base_of<
             std::input_iterator_tag,
             typename std::iterator_traits<InputIterator>::iterator_category
         >::value,
-    iterator>::type insert(const_iterator position, InputIterator first, InputIterator last);
+    iterator>::type insert(const_iterator position, InputIterator first, InputIterator last) {
+        return insert_range(position, first, last,
+                            typename std::iterator_traits<InputIterator>::iterator_category());
+    }
 
+    DEVECTOR_CONSTEXPR
     iterator erase(const_iterator position) { return erase(position, position + 1); }
 
-    iterator erase(const_iterator first, const_iterator last) {
+    DEVECTOR_CONSTEXPR iterator erase(const_iterator first, const_iterator last) {
         difference_type n = last - first;
         difference_type retpos = first - begin();
-
-        if (first - begin() < end() - last) {
-            std::move_backward(begin(), first, first + n);
-            while (n--) pop_front();
+        iterator mut_first = begin() + retpos; // const_iterator to iterator
+        iterator mut_last = mut_first + n;
+        if (n == 0) return mut_first;
+
+        bool removed_front = mut_last != end() &&
+                             (mut_first == begin() || mut_first - begin() < end() - mut_last);
+
+        // Erasing a prefix or suffix only destroys, nothing is moved.
+        if (mut_last == end()) {
+            while (n--) destroy_back();
+        } else if (mut_first == begin()) {
+            while (n--) destroy_front();
+        } else if (removed_front) {
+            std::move_backward(begin(), mut_first, mut_last);
+            while (n--) destroy_front();
         } else {
-            std::move(last, end(), last - n);
-            while (n--) pop_back();
+            std::move(mut_last, end(), mut_first);
+            while (n--) destroy_back();
         }
 
+        reclaim(removed_front);
         return begin() + retpos;
     }
 
-    void swap(V& other)
+    DEVECTOR_CONSTEXPR void swap(V& other)
     noexcept(!alloc_traits::propagate_on_container_swap::value ||
              detail::is_nothrow_swappable<Allocator>::value) {
         using std::swap;
@@ -428,13 +685,13 @@ public:
         swap(impl.storage(), other.impl.storage());
     }
 
-    void clear() noexcept {
-        while (begin() != end()) pop_back();
+    DEVECTOR_CONSTEXPR void clear() noexcept {
+        while (begin() != end()) destroy_back();
     }
 
 private:
     struct ImplStorage {
-        void null() {
+        DEVECTOR_CONSTEXPR void null() {
             begin_storage = end_storage = nullptr;
             begin_cursor = end_cursor = nullptr;
         }
@@ -447,56 +704,169 @@ private:
 
     // Empty base class optimization.
     struct Impl : ImplStorage, Allocator {
+        DEVECTOR_CONSTEXPR
         Impl() noexcept(std::is_nothrow_default_constructible<Allocator>::value) : Allocator() { }
+        DEVECTOR_CONSTEXPR
         explicit Impl(const Allocator& alloc) noexcept : Allocator(alloc) { }
+        DEVECTOR_CONSTEXPR
         explicit Impl(Allocator&& alloc) noexcept : Allocator(std::move(alloc)) { }
 
-        Allocator& alloc() { return *this; }
-        const Allocator& alloc() const { return *this; }
+        DEVECTOR_CONSTEXPR Allocator& alloc() { return *this; }
+        DEVECTOR_CONSTEXPR const Allocator& alloc() const { return *this; }
         
-        Allocator& storage() { return *this; }
-        const Allocator& storage() const { return *this; }
+        DEVECTOR_CONSTEXPR ImplStorage& storage() { return *this; }
+        DEVECTOR_CONSTEXPR const ImplStorage& storage() const { return *this; }
     } impl;
 
+    // Destroys the first/last element without consulting the reclaim policy.
+    DEVECTOR_CONSTEXPR void destroy_front() noexcept {
+        alloc_traits::destroy(impl, std::addressof(*impl.begin_cursor++));
+    }
+
+    DEVECTOR_CONSTEXPR void destroy_back() noexcept {
+        alloc_traits::destroy(impl, std::addressof(*--impl.end_cursor));
+    }
+
+    // Called after elements are removed, from the front if removed_front is set. If the reclaim
+    // policy asks for it, reallocates leaving as much free space on each end as growing would. Any
+    // extra memory from the allocator goes to the other end, which is the one that may grow next.
+    // Reclaiming is only an optimization, so if it fails the devector is left as is.
+    DEVECTOR_CONSTEXPR void reclaim(bool removed_front) noexcept {
+        if (!ReclaimPolicy::enabled) return;
+        if (!ReclaimPolicy::should_reclaim(size(), capacity())) return;
+
+        if (empty()) {
+            deallocate();
+            impl.null();
+            return;
+        }
+
+        size_type sz = size();
+        size_type keep = sz >= 16 ? sz / 3 : sz;
+        if (detail::good_size(impl.alloc(), keep + sz + keep) >= capacity()) return;
+
+        try {
+            reallocate_smaller(keep, keep, !removed_front);
+        } catch (...) { }
+    }
+
     // Deallocates the stored memory. Does not leave the devector in a valid state!
-    void deallocate() noexcept {
-        alloc_traits::deallocate(impl, impl.begin_storage, capacity());
+    // Null storage is skipped, deallocating it is not allowed during constant evaluation.
+    DEVECTOR_CONSTEXPR void deallocate() noexcept {
+        if (impl.begin_storage) alloc_traits::deallocate(impl, impl.begin_storage, capacity());
     }
 
     // Deletes all elements and deallocates memory. Does not leave the devector in a valid state.
-    void destruct() noexcept {
+    DEVECTOR_CONSTEXPR void destruct() noexcept {
         clear();
         deallocate();
     }
 
-    // Reallocate with exactly space_front free space in the front, and space_back in the back.
-    void reallocate(size_type space_front, size_type space_back) {
+    // Releases free space through the allocator's shrink_in_place instead of reallocating, keeping
+    // space_back free at the back. The free space at the front is kept if keep_front is set,
+    // otherwise the elements are first moved to the start of the storage, which is only done if
+    // that can't throw. Returns false if nothing was released.
+    DEVECTOR_CONSTEXPR bool shrink_in_place(bool keep_front, size_type space_back) {
+        return shrink_in_place_dispatcher(keep_front, space_back,
+                                          detail::has_shrink_in_place<Allocator>());
+    }
+
+    DEVECTOR_CONSTEXPR bool shrink_in_place_dispatcher(bool, size_type, std::false_type) {
+        return false;
+    }
+
+    DEVECTOR_CONSTEXPR bool shrink_in_place_dispatcher(bool keep_front, size_type space_back,
+                                                      std::true_type) {
+        if (!keep_front && impl.begin_cursor != impl.begin_storage) {
+            if (!std::is_nothrow_move_constructible<T>::value) return false;
+
+            // Going from the front, every destination is either free or already moved from.
+            pointer dest = impl.begin_storage;
+            for (pointer src = impl.begin_cursor; src != impl.end_cursor; ++src, ++dest) {
+                alloc_traits::construct(impl, std::addressof(*dest), std::move(*src));
+                alloc_traits::destroy(impl, std::addressof(*src));
+            }
+
+            impl.begin_cursor = impl.begin_storage;
+            impl.end_cursor = dest;
+        }
+
+        size_type count = capacity();
+        size_type n = (impl.end_cursor - impl.begin_storage) + space_back;
+        count = detail::shrink_in_place(impl.alloc(), impl.begin_storage, count, n);
+        if (count >= capacity()) return false;
+
+        impl.end_storage = impl.begin_storage + count;
+        return true;
+    }
+
+    // Reallocate with at least space_front free space in the front, and space_back in the back. If
+    // the allocator returns more memory than requested, the extra goes to the front if
+    // surplus_front is set and to the back otherwise, which should be the side that is growing.
+    DEVECTOR_CONSTEXPR void reallocate(size_type space_front, size_type space_back,
+                                       bool surplus_front) {
         // TODO It's possible that the user chose values such that the total new capacity needed is
         // smaller than capacity(). In that case we should not request a new memory chunk from the
         // allocator.
 
         size_type alloc_size = space_front + size() + space_back;
+        reallocate_into(detail::allocate_at_least(impl.alloc(), alloc_size),
+                        space_front, space_back, surplus_front);
+    }
+
+    // Like reallocate, but keeps the current storage if the allocator would not return less of it,
+    // for example because it rounds up to huge pages. Otherwise reclaim would reallocate on every
+    // removal without ever lowering capacity().
+    DEVECTOR_CONSTEXPR void reallocate_smaller(size_type space_front, size_type space_back,
+                                               bool surplus_front) {
+        size_type alloc_size = space_front + size() + space_back;
+        auto mem = detail::allocate_at_least(impl.alloc(), alloc_size);
+        if (mem.count >= capacity()) {
+            alloc_traits::deallocate(impl, mem.ptr, mem.count);
+            return;
+        }
+
+        reallocate_into(mem, space_front, space_back, surplus_front);
+    }
+
+    // Moves the elements into the newly allocated mem, which has room for at least space_front +
+    // size() + space_back elements, and frees the old storage.
+    DEVECTOR_CONSTEXPR void reallocate_into(const detail::allocation_result<Allocator>& mem,
+                                            size_type space_front, size_type space_back,
+                                            bool surplus_front) {
+        size_type sz = size();
+        size_type min_front = space_front;
+        size_type max_front = mem.count - sz - space_back;
+        if (surplus_front) space_front = max_front;
+
+        // Move the cursor to an aligned position if the allocator asks for it and there is room.
+        size_type align = detail::cursor_alignment(impl.alloc());
+        if (align > 1) {
+            size_type up = (space_front + align - 1) / align * align;
+            size_type down = space_front / align * align;
+            if (up <= max_front) space_front = up;
+            else if (down >= min_front) space_front = down;
+        }
 
-        pointer new_storage = alloc_traits::allocate(impl, alloc_size);
-        pointer new_begin_cursor = new_storage + space_front;
+        pointer new_begin_cursor = mem.ptr + space_front;
 
         try {
             alloc_uninitialized_copy(detail::make_move_if_noexcept_iterator(begin()),
                                       detail::make_move_if_noexcept_iterator(end()),
                                       new_begin_cursor);
-        } catch (...) { alloc_traits::deallocate(impl, new_storage, alloc_size); throw; }
+        } catch (...) { alloc_traits::deallocate(impl, mem.ptr, mem.count); throw; }
 
         destruct();
-        impl.begin_storage = new_storage;
-        impl.end_storage = new_storage + alloc_size;
+        impl.begin_storage = mem.ptr;
+        impl.end_storage = mem.ptr + mem.count;
         impl.begin_cursor = new_begin_cursor;
-        impl.end_cursor = impl.end_storage - space_back;
+        impl.end_cursor = new_begin_cursor + sz;
     }
 
 
     // Make sure there is space for at least n elements at the front of the devector. This may steal
     // space from the back.
-    void assure_space_front(size_type n) {
+    DEVECTOR_CONSTEXPR void assure_space_front(size_type n) {
         if (impl.begin_cursor - impl.begin_storage >= difference_type(n)) return;
 
         // Don't compute this multiple times.
@@ -511,8 +881,8 @@ private:
         if (mem_req > cap)  {
             // Use exponential growth with factor 1.5 (2 for small sizes) if possible.
             size_type alloc_size = cap * (3 + (cap < 16)) / 2;
-            if (mem_req > alloc_size) reallocate(space_front_req,              space_back);
-            else                      reallocate(alloc_size - sz - space_back, space_back);
+            if (mem_req > alloc_size) reallocate(space_front_req,              space_back, true);
+            else                      reallocate(alloc_size - sz - space_back, space_back, true);
         } else {
             // We have enough space already, we just have to move elements around.
             pointer new_end_cursor = impl.end_storage - space_back;
@@ -530,7 +900,7 @@ private:
                                end());
 
             // Update cursors and destruct the values at the old beginning.
-            while (num_move--) pop_front();
+            while (num_move--) destroy_front();
             impl.begin_cursor = new_end_cursor - sz;
             impl.end_cursor = new_end_cursor;
         }
@@ -539,7 +909,7 @@ private:
 
     // Make sure there is space for at least n elements at the back of the devector. This may steal
     // space from the front.
-    void assure_space_back(size_type n) {
+    DEVECTOR_CONSTEXPR void assure_space_back(size_type n) {
         if (impl.end_storage - impl.end_cursor >= difference_type(n)) return;
         
         // Don't compute this multiple times.
@@ -554,8 +924,8 @@ private:
         if (mem_req > cap)  {
             // Use exponential growth with factor 1.5 (2 for small sizes) if possible.
             size_type alloc_size = cap * (3 + (cap < 16)) / 2;
-            if (mem_req > alloc_size) reallocate(space_front, space_back_req);
-            else                      reallocate(space_front, alloc_size - sz - space_front);
+            if (mem_req > alloc_size) reallocate(space_front, space_back_req, false);
+            else                      reallocate(space_front, alloc_size - sz - space_front, false);
         } else {
             // We have enough space already, we just have to move elements around.
             pointer new_begin_cursor = impl.begin_storage + space_front;
@@ -574,7 +944,7 @@ private:
                       new_begin_cursor + num_move);
 
             // Update cursors and destruct the values at the old beginning.
-            while (num_move--) pop_back();
+            while (num_move--) destroy_back();
             impl.begin_cursor = new_begin_cursor;
             impl.end_cursor = new_begin_cursor + sz;
         }
@@ -583,6 +953,7 @@ private:
     // Fills [first, last) with constructed elements with args. Strong exception guarantee, cleans
     // up if an exception occurs.
     template<class... Args>
+    DEVECTOR_CONSTEXPR
     pointer alloc_uninitialized_fill(pointer first, pointer last, Args&&... args) {
         pointer current = first;
 
@@ -601,6 +972,7 @@ private:
     // Copies from the range [first, last) into the uninitialized range starting at d_first. Strong
     // exception guarantee, cleans up if an exception occurs.
     template<class InputIterator>
+    DEVECTOR_CONSTEXPR
     pointer alloc_uninitialized_copy(InputIterator first, InputIterator last, pointer d_first) {
         pointer current = d_first;
 
@@ -618,6 +990,7 @@ private:
 
     // Initializes the devector with copies from [first, last). Strong exception guarantee.
     template<class InputIterator>
+    DEVECTOR_CONSTEXPR
     void init_range(InputIterator first, InputIterator last, std::random_access_iterator_tag) {
         size_type n = last - first;
 
@@ -632,40 +1005,108 @@ private:
 
     // Initializes the devector with copies from [first, last). Strong exception guarantee.
     template<class InputIterator>
+    DEVECTOR_CONSTEXPR
     void init_range(InputIterator first, InputIterator last, std::bidirectional_iterator_tag) {
         impl.null();
         while (first != last) push_back(*first++);
     }
 
 
+    // Inserts the elements produced by calling emplace_one at the front until it returns false,
+    // then rotates them into position. Strong exception guarantee if no reallocation happens.
+    template<class EmplaceOne>
+    DEVECTOR_CONSTEXPR void insert_front_impl(difference_type pos, EmplaceOne emplace_one) {
+        size_type original_size = size();
+
+        try {
+            while (emplace_one()) { }
+        } catch (...) {
+            while (size() > original_size) destroy_front();
+            throw;
+        }
+
+        // The new elements were pushed in reverse order.
+        difference_type n = size() - original_size;
+        std::reverse(begin(), begin() + n);
+        std::rotate(begin(), begin() + n, begin() + n + pos);
+    }
+
+    // Same as insert_front_impl, but inserts at the back.
+    template<class EmplaceOne>
+    DEVECTOR_CONSTEXPR void insert_back_impl(difference_type pos, EmplaceOne emplace_one) {
+        size_type original_size = size();
+
+        try {
+            while (emplace_one()) { }
+        } catch (...) {
+            while (size() > original_size) destroy_back();
+            throw;
+        }
+
+        std::rotate(begin() + pos, begin() + original_size, end());
+    }
+
+    template<class ForwardIterator>
+    DEVECTOR_CONSTEXPR
+    iterator insert_range(const_iterator position, ForwardIterator first, ForwardIterator last,
+                          std::forward_iterator_tag) {
+        difference_type dist_front = position - begin();
+        size_type n = std::distance(first, last);
+        if (n == 0) return begin() + dist_front;
+
+        if (dist_front < end() - position) {
+            assure_space_front(n);
+            insert_front_impl(dist_front, [&]() { emplace_front(*first); return ++first != last; });
+        } else {
+            assure_space_back(n);
+            insert_back_impl(dist_front, [&]() { emplace_back(*first); return ++first != last; });
+        }
+
+        return begin() + dist_front;
+    }
+
+    // A single pass input range has unknown length, so always append at the back.
+    template<class InputIterator>
+    DEVECTOR_CONSTEXPR
+    iterator insert_range(const_iterator position, InputIterator first, InputIterator last,
+                          std::input_iterator_tag) {
+        difference_type dist_front = position - begin();
+        if (first == last) return begin() + dist_front;
+
+        insert_back_impl(dist_front, [&]() { emplace_back(*first); return ++first != last; });
+        return begin() + dist_front;
+    }
+
     template<class InputIterator>
+    DEVECTOR_CONSTEXPR
     void assign_range(InputIterator first, InputIterator last, std::random_access_iterator_tag) {
         size_type n = last - first;
         reserve(n);
 
-        while (size() > n) pop_back();
+        while (size() > n) destroy_back();
         for (auto& el : *this) el = *first++;
         while (first != last) push_back(*first++);
     }
 
     template<class InputIterator>
+    DEVECTOR_CONSTEXPR
     void assign_range(InputIterator first, InputIterator last, std::bidirectional_iterator_tag) {
         auto it = begin();
         while (it != end() && first != last) *it++ = *first++;
-        while (it != end()) pop_back();
+        while (it != end()) destroy_back();
         while (first != last) push_back(*first++);
     }
 
     // Helper functions for move assignment. Second argument is 
     // alloc_traits::propagate_on_container_move_assignment::value.
-    void move_assign_propagate_dispatcher(V&& other, std::true_type) noexcept {
+    DEVECTOR_CONSTEXPR void move_assign_propagate_dispatcher(V&& other, std::true_type) noexcept {
         destruct();
         impl.alloc() = std::move(other.impl.alloc());
         impl.storage() = std::move(other.impl.storage());
         other.impl.null();
     }
 
-    void move_assign_propagate_dispatcher(V&& other, std::false_type) {
+    DEVECTOR_CONSTEXPR void move_assign_propagate_dispatcher(V&& other, std::false_type) {
         if (impl.alloc() != other.impl.alloc()) {
             destruct();
             impl.null();
@@ -680,7 +1121,7 @@ private:
     
     // Helper functions for copy assignment. Second argument is 
     // alloc_traits::propagate_on_container_copy_assignment::value.
-    void copy_assign_propagate_dispatcher(const V& other, std::true_type) {
+    DEVECTOR_CONSTEXPR void copy_assign_propagate_dispatcher(const V& other, std::true_type) {
         if (impl.alloc() != other.impl.alloc()) {
             destruct();
             impl.null();
@@ -690,36 +1131,46 @@ private:
         assign(other.begin(), other.end());
     }
 
-    void copy_assign_propagate_dispatcher(const V& other, std::false_type) {
+    DEVECTOR_CONSTEXPR void copy_assign_propagate_dispatcher(const V& other, std::false_type) {
         assign(other.begin(), other.end());
     }
 
     template<class... Args>
-    void resize_back_impl(size_type n, Args&&... args) {
+    DEVECTOR_CONSTEXPR void resize_back_impl(size_type n, Args&&... args) {
         auto original_size = size();
 
+        if (n < size()) {
+            while (n < size()) destroy_back();
+            reclaim(false);
+            return;
+        }
+
         reserve_back(n);
-        while (n < size()) pop_back();
 
         try {
             while (n > size()) emplace_back(args...);
         } catch (...) {
-            while (size() > original_size) pop_back();
+            while (size() > original_size) destroy_back();
             throw;
         }
     }
 
     template<class... Args>
-    void resize_front_impl(size_type n, Args&&... args) {
+    DEVECTOR_CONSTEXPR void resize_front_impl(size_type n, Args&&... args) {
         auto original_size = size();
 
-        reserve_back(n);
-        while (n < size()) pop_front();
+        if (n < size()) {
+            while (n < size()) destroy_front();
+            reclaim(true);
+            return;
+        }
+
+        reserve_front(n);
 
         try {
             while (n > size()) emplace_front(args...);
         } catch (...) {
-            while (size() > original_size) pop_front();
+            while (size() > original_size) destroy_front();
             throw;
         }
     }
@@ -727,38 +1178,45 @@ private:
 
 
 // Comparison operators.
-template<class T, class Allocator>
-inline bool operator==(const devector<T, Allocator>& lhs, const devector<T, Allocator>& rhs) {
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR bool operator==(const devector<T, Allocator, ReclaimPolicy>& lhs,
+                                          const devector<T, Allocator, ReclaimPolicy>& rhs) {
     return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template<class T, class Allocator>
-inline bool operator< (const devector<T, Allocator>& lhs, const devector<T, Allocator>& rhs) {
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR bool operator< (const devector<T, Allocator, ReclaimPolicy>& lhs,
+                                          const devector<T, Allocator, ReclaimPolicy>& rhs) {
     return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template<class T, class Allocator>
-inline bool operator!=(const devector<T, Allocator>& lhs, const devector<T, Allocator>& rhs) {
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR bool operator!=(const devector<T, Allocator, ReclaimPolicy>& lhs,
+                                          const devector<T, Allocator, ReclaimPolicy>& rhs) {
     return !(lhs == rhs);
 }
 
-template<class T, class Allocator>
-inline bool operator> (const devector<T, Allocator>& lhs, const devector<T, Allocator>& rhs) {
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR bool operator> (const devector<T, Allocator, ReclaimPolicy>& lhs,
+                                          const devector<T, Allocator, ReclaimPolicy>& rhs) {
     return rhs < lhs;
 }
 
-template<class T, class Allocator>
-inline bool operator<=(const devector<T, Allocator>& lhs, const devector<T, Allocator>& rhs) {
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR bool operator<=(const devector<T, Allocator, ReclaimPolicy>& lhs,
+                                          const devector<T, Allocator, ReclaimPolicy>& rhs) {
     return !(rhs < lhs);
 }
 
-template<class T, class Allocator>
-inline bool operator>=(const devector<T, Allocator>& lhs, const devector<T, Allocator>& rhs) {
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR bool operator>=(const devector<T, Allocator, ReclaimPolicy>& lhs,
+                                          const devector<T, Allocator, ReclaimPolicy>& rhs) {
     return !(lhs < rhs);
 }
 
-template<class T, class Allocator>
-inline void swap(devector<T, Allocator>& lhs, devector<T, Allocator>& rhs)
+template<class T, class Allocator, class ReclaimPolicy>
+inline DEVECTOR_CONSTEXPR void swap(devector<T, Allocator, ReclaimPolicy>& lhs,
+                                    devector<T, Allocator, ReclaimPolicy>& rhs)
 noexcept(noexcept(lhs.swap(rhs))) {
     lhs.swap(rhs);
 }
@@ -0,0 +1,496 @@
+/*
+    Copyright (c) 2014 Orson Peters
+
+    This software is provided 'as-is', without any express or implied warranty. In no event will the
+    authors be held liable for any damages arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose, including commercial
+    applications, and to alter it and redistribute it freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+       original software. If you use this software in a product, an acknowledgement in the product
+       documentation would be appreciated but is not required.
+    2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+       being the original software.
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef DEVECTOR_FLAT_MAP_H
+#define DEVECTOR_FLAT_MAP_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "devector.h"
+
+
+
+// Tag to indicate that a range passed to flat_set/flat_map is already sorted and free of
+// duplicates, which skips sorting and merging it.
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+constexpr sorted_unique_t sorted_unique{};
+
+
+namespace detail {
+    // Binary search without a data dependent branch in the loop, the compiler turns the
+    // conditional increment into a conditional move. Returns the first element in [first, last)
+    // whose key does not compare less than key.
+    template<class RandomIt, class K, class KeyOfValue, class Compare>
+    RandomIt branchless_lower_bound(RandomIt first, RandomIt last, const K& key,
+                                    KeyOfValue key_of, const Compare& comp) {
+        typedef typename std::iterator_traits<RandomIt>::difference_type difference_type;
+
+        difference_type len = last - first;
+        if (len == 0) return first;
+
+        while (len > 1) {
+            difference_type half = len / 2;
+            first += comp(key_of(first[half]), key) ? half : 0;
+            len -= half;
+        }
+
+        return first + comp(key_of(*first), key);
+    }
+
+    struct identity_key {
+        template<class T> const T& operator()(const T& t) const noexcept { return t; }
+    };
+
+    struct first_key {
+        template<class P> const typename P::first_type& operator()(const P& p) const noexcept {
+            return p.first;
+        }
+    };
+
+    // Shared implementation of flat_set and flat_map. Elements are kept sorted by key and unique
+    // in a devector, so inserting or erasing only shifts the elements on the shorter side.
+    template<class Value, class Key, class KeyOfValue, class Compare, class Allocator>
+    class flat_tree {
+    private:
+        typedef devector<Value, Allocator> container_type;
+
+        // In a set the value is the key, so like std::set only const access is given out.
+        static constexpr bool const_values = std::is_same<KeyOfValue, identity_key>::value;
+
+    public:
+        // Typedefs.
+        typedef Key                                              key_type;
+        typedef Value                                            value_type;
+        typedef Compare                                          key_compare;
+        typedef Allocator                                        allocator_type;
+        typedef typename container_type::size_type               size_type;
+        typedef typename container_type::difference_type         difference_type;
+        typedef typename container_type::pointer                 pointer;
+        typedef typename container_type::const_pointer           const_pointer;
+        typedef typename container_type::reference               reference;
+        typedef typename container_type::const_reference         const_reference;
+        typedef typename container_type::const_iterator          const_iterator;
+        typedef typename container_type::const_reverse_iterator  const_reverse_iterator;
+        typedef typename std::conditional<const_values,
+            const_iterator, typename container_type::iterator
+        >::type iterator;
+        typedef typename std::conditional<const_values,
+            const_reverse_iterator, typename container_type::reverse_iterator
+        >::type reverse_iterator;
+
+        struct value_compare {
+            bool operator()(const Value& a, const Value& b) const {
+                return comp(KeyOfValue()(a), KeyOfValue()(b));
+            }
+
+            Compare comp;
+        };
+
+        // Construct/copy/destroy.
+        flat_tree() : impl() { }
+        explicit flat_tree(const Compare& comp, const Allocator& alloc = Allocator())
+        : impl(comp, alloc) { }
+        explicit flat_tree(const Allocator& alloc) : impl(Compare(), alloc) { }
+
+        template<class InputIterator>
+        flat_tree(InputIterator first, InputIterator last, const Compare& comp = Compare(),
+                  const Allocator& alloc = Allocator())
+        : impl(comp, alloc) {
+            insert(first, last);
+        }
+
+        template<class InputIterator>
+        flat_tree(sorted_unique_t, InputIterator first, InputIterator last,
+                  const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : impl(comp, alloc) {
+            impl.seq.assign(first, last);
+        }
+
+        flat_tree(std::initializer_list<Value> il, const Compare& comp = Compare(),
+                  const Allocator& alloc = Allocator())
+        : impl(comp, alloc) {
+            insert(il.begin(), il.end());
+        }
+
+        flat_tree& operator=(std::initializer_list<Value> il) {
+            clear();
+            insert(il.begin(), il.end());
+            return *this;
+        }
+
+        allocator_type get_allocator() const noexcept { return impl.seq.get_allocator(); }
+        key_compare key_comp() const { return impl.comp(); }
+        value_compare value_comp() const { return value_compare{impl.comp()}; }
+
+        // Iterators.
+        iterator               begin()         noexcept { return impl.seq.begin();   }
+        const_iterator         begin()   const noexcept { return impl.seq.begin();   }
+        iterator               end()           noexcept { return impl.seq.end();     }
+        const_iterator         end()     const noexcept { return impl.seq.end();     }
+        reverse_iterator       rbegin()        noexcept { return impl.seq.rbegin();  }
+        const_reverse_iterator rbegin()  const noexcept { return impl.seq.rbegin();  }
+        reverse_iterator       rend()          noexcept { return impl.seq.rend();    }
+        const_reverse_iterator rend()    const noexcept { return impl.seq.rend();    }
+        const_iterator         cbegin()  const noexcept { return impl.seq.cbegin();  }
+        const_iterator         cend()    const noexcept { return impl.seq.cend();    }
+        const_reverse_iterator crbegin() const noexcept { return impl.seq.crbegin(); }
+        const_reverse_iterator crend()   const noexcept { return impl.seq.crend();   }
+
+        // Capacity.
+        bool      empty()    const noexcept { return impl.seq.empty();    }
+        size_type size()     const noexcept { return impl.seq.size();     }
+        size_type max_size() const noexcept { return impl.seq.max_size(); }
+        size_type capacity() const noexcept { return impl.seq.capacity(); }
+
+        void reserve(size_type new_front, size_type new_back) {
+            impl.seq.reserve(new_front, new_back);
+        }
+
+        void reserve(size_type n) { impl.seq.reserve(n); }
+        void shrink_to_fit() { impl.seq.shrink_to_fit(); }
+
+        // Modifiers.
+        template<class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            return insert_unique(Value(std::forward<Args>(args)...));
+        }
+
+        template<class... Args>
+        iterator emplace_hint(const_iterator hint, Args&&... args) {
+            return insert_unique(hint, Value(std::forward<Args>(args)...));
+        }
+
+        std::pair<iterator, bool> insert(const Value& v) { return insert_unique(Value(v)); }
+        std::pair<iterator, bool> insert(Value&& v) { return insert_unique(std::move(v)); }
+
+        iterator insert(const_iterator hint, const Value& v) {
+            return insert_unique(hint, Value(v));
+        }
+
+        iterator insert(const_iterator hint, Value&& v) {
+            return insert_unique(hint, std::move(v));
+        }
+
+        // Bulk insertion. The new elements are appended, sorted and merged with the existing
+        // elements in O(n + k log k) rather than O(n * k) for k separate inserts. If a key is
+        // already present (or repeated in the range) only the first occurrence is kept.
+        template<class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            size_type old_size = size();
+            impl.seq.insert(impl.seq.end(), first, last);
+
+            std::stable_sort(impl.seq.begin() + old_size, impl.seq.end(), value_comp());
+            merge_unique(old_size);
+        }
+
+        template<class InputIterator>
+        void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+            size_type old_size = size();
+            impl.seq.insert(impl.seq.end(), first, last);
+            merge_unique(old_size);
+        }
+
+        void insert(std::initializer_list<Value> il) { insert(il.begin(), il.end()); }
+
+        iterator erase(const_iterator position) { return impl.seq.erase(position); }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            return impl.seq.erase(first, last);
+        }
+
+        size_type erase(const Key& key) {
+            std::pair<iterator, iterator> range = equal_range(key);
+            size_type n = range.second - range.first;
+            erase(range.first, range.second);
+            return n;
+        }
+
+        void swap(flat_tree& other)
+        noexcept(noexcept(std::declval<container_type&>().swap(std::declval<container_type&>()))
+                 && detail::is_nothrow_swappable<Compare>::value) {
+            using std::swap;
+            swap(impl.comp(), other.impl.comp());
+            impl.seq.swap(other.impl.seq);
+        }
+
+        void clear() noexcept { impl.seq.clear(); }
+
+        // Lookup. The overloads templated on K only take part in overload resolution if Compare
+        // is transparent, allowing lookup without constructing a Key.
+        iterator       find(const Key& key)       { return find_impl<iterator>(*this, key); }
+        const_iterator find(const Key& key) const { return find_impl<const_iterator>(*this, key); }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        iterator find(const K& key) {
+            return find_impl<iterator>(*this, key);
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator find(const K& key) const {
+            return find_impl<const_iterator>(*this, key);
+        }
+
+        size_type count(const Key& key) const { return find(key) != end(); }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        size_type count(const K& key) const { return find(key) != end(); }
+
+        bool contains(const Key& key) const { return find(key) != end(); }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        bool contains(const K& key) const { return find(key) != end(); }
+
+        iterator lower_bound(const Key& key) {
+            return branchless_lower_bound(begin(), end(), key, KeyOfValue(), impl.comp());
+        }
+
+        const_iterator lower_bound(const Key& key) const {
+            return branchless_lower_bound(begin(), end(), key, KeyOfValue(), impl.comp());
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        iterator lower_bound(const K& key) {
+            return branchless_lower_bound(begin(), end(), key, KeyOfValue(), impl.comp());
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator lower_bound(const K& key) const {
+            return branchless_lower_bound(begin(), end(), key, KeyOfValue(), impl.comp());
+        }
+
+        iterator upper_bound(const Key& key) {
+            return upper_bound_impl<iterator>(*this, key);
+        }
+
+        const_iterator upper_bound(const Key& key) const {
+            return upper_bound_impl<const_iterator>(*this, key);
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        iterator upper_bound(const K& key) {
+            return upper_bound_impl<iterator>(*this, key);
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator upper_bound(const K& key) const {
+            return upper_bound_impl<const_iterator>(*this, key);
+        }
+
+        std::pair<iterator, iterator> equal_range(const Key& key) {
+            return equal_range_impl<iterator>(*this, key);
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+            return equal_range_impl<const_iterator>(*this, key);
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        std::pair<iterator, iterator> equal_range(const K& key) {
+            return equal_range_impl<iterator>(*this, key);
+        }
+
+        template<class K, class C = Compare, class = typename C::is_transparent>
+        std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+            return equal_range_impl<const_iterator>(*this, key);
+        }
+
+    protected:
+        // Inserts v if its key is not yet present. Returns the position of the element with the
+        // key of v and whether the insertion took place.
+        std::pair<iterator, bool> insert_unique(Value&& v) {
+            const Key& key = KeyOfValue()(v);
+
+            // Appending in order is common enough to skip the binary search for.
+            if (empty() || impl.comp()(KeyOfValue()(impl.seq.back()), key)) {
+                impl.seq.push_back(std::move(v));
+                return std::make_pair(end() - 1, true);
+            }
+
+            iterator it = lower_bound(key);
+            if (impl.comp()(key, KeyOfValue()(*it))) {
+                return std::make_pair(impl.seq.insert(it, std::move(v)), true);
+            }
+
+            return std::make_pair(it, false);
+        }
+
+        // Same as above, but uses hint if v belongs directly before it.
+        iterator insert_unique(const_iterator hint, Value&& v) {
+            const Key& key = KeyOfValue()(v);
+
+            bool after_prev = hint == begin() || impl.comp()(KeyOfValue()(*(hint - 1)), key);
+            bool before_hint = hint == end() || impl.comp()(key, KeyOfValue()(*hint));
+            if (after_prev && before_hint) return impl.seq.insert(hint, std::move(v));
+
+            return insert_unique(std::move(v)).first;
+        }
+
+        // Merges the sorted range [begin() + n, end()) into the sorted range [begin(), begin() + n)
+        // and removes elements with duplicate keys, keeping the first of each.
+        void merge_unique(size_type n) {
+            value_compare vcomp = value_comp();
+            typename container_type::iterator first = impl.seq.begin();
+            typename container_type::iterator mid = first + n;
+            typename container_type::iterator last = impl.seq.end();
+
+            // Nothing to merge if the new elements all go at the end (append-mostly streams).
+            if (mid != first && mid != last && !vcomp(*(mid - 1), *mid)) {
+                std::inplace_merge(first, mid, last, vcomp);
+            }
+
+            // Sorted, so equivalent elements are adjacent and a does not compare less than b.
+            last = std::unique(first, last, [&](const Value& a, const Value& b) {
+                return !vcomp(a, b);
+            });
+            impl.seq.erase(last, impl.seq.end());
+        }
+
+        template<class It, class Self, class K>
+        static It find_impl(Self& self, const K& key) {
+            It it = self.lower_bound(key);
+            if (it != self.end() && !self.impl.comp()(key, KeyOfValue()(*it))) return it;
+            return self.end();
+        }
+
+        template<class It, class Self, class K>
+        static It upper_bound_impl(Self& self, const K& key) {
+            It it = self.lower_bound(key);
+            if (it != self.end() && !self.impl.comp()(key, KeyOfValue()(*it))) ++it;
+            return it;
+        }
+
+        template<class It, class Self, class K>
+        static std::pair<It, It> equal_range_impl(Self& self, const K& key) {
+            It it = self.lower_bound(key);
+            if (it != self.end() && !self.impl.comp()(key, KeyOfValue()(*it))) {
+                return std::make_pair(it, it + 1);
+            }
+
+            return std::make_pair(it, it);
+        }
+
+        // Empty base class optimization.
+        struct Impl : Compare {
+            Impl() : Compare(), seq() { }
+            Impl(const Compare& comp, const Allocator& alloc) : Compare(comp), seq(alloc) { }
+
+            Compare& comp() { return *this; }
+            const Compare& comp() const { return *this; }
+
+            container_type seq;
+        } impl;
+
+        friend bool operator==(const flat_tree& lhs, const flat_tree& rhs) {
+            return lhs.impl.seq == rhs.impl.seq;
+        }
+
+        friend bool operator<(const flat_tree& lhs, const flat_tree& rhs) {
+            return lhs.impl.seq < rhs.impl.seq;
+        }
+
+        friend bool operator!=(const flat_tree& lhs, const flat_tree& rhs) { return !(lhs == rhs); }
+        friend bool operator> (const flat_tree& lhs, const flat_tree& rhs) { return rhs < lhs;     }
+        friend bool operator<=(const flat_tree& lhs, const flat_tree& rhs) { return !(rhs < lhs);  }
+        friend bool operator>=(const flat_tree& lhs, const flat_tree& rhs) { return !(lhs < rhs);  }
+
+        friend void swap(flat_tree& lhs, flat_tree& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+            lhs.swap(rhs);
+        }
+    };
+}
+
+
+template<class Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
+class flat_set : public detail::flat_tree<Key, Key, detail::identity_key, Compare, Allocator> {
+private:
+    typedef detail::flat_tree<Key, Key, detail::identity_key, Compare, Allocator> base;
+
+public:
+    using base::base;
+    using base::operator=;
+};
+
+
+template<class Key, class T, class Compare = std::less<Key>,
+         class Allocator = std::allocator<std::pair<Key, T>>>
+class flat_map
+: public detail::flat_tree<std::pair<Key, T>, Key, detail::first_key, Compare, Allocator> {
+private:
+    typedef detail::flat_tree<std::pair<Key, T>, Key, detail::first_key, Compare, Allocator> base;
+
+public:
+    typedef T mapped_type;
+
+    using base::base;
+    using base::operator=;
+
+    // Element access.
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+    T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+    T& at(const Key& key) {
+        typename base::iterator it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("flat_map");
+        return it->second;
+    }
+
+    const T& at(const Key& key) const {
+        typename base::const_iterator it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("flat_map");
+        return it->second;
+    }
+
+    // Modifiers. Unlike emplace these do not construct a value if the key is already present.
+    template<class... Args>
+    std::pair<typename base::iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<typename base::iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<class M>
+    std::pair<typename base::iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+        std::pair<typename base::iterator, bool> r = try_emplace(key, std::forward<M>(obj));
+        if (!r.second) r.first->second = std::forward<M>(obj);
+        return r;
+    }
+
+private:
+    template<class K, class... Args>
+    std::pair<typename base::iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+        typename base::iterator it = this->lower_bound(key);
+        if (it != this->end() && !this->impl.comp()(key, it->first)) {
+            return std::make_pair(it, false);
+        }
+
+        it = this->impl.seq.emplace(it, std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<K>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(it, true);
+    }
+};
+
+#endif
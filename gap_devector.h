@@ -0,0 +1,663 @@
+/*
+    Copyright (c) 2014 Orson Peters
+
+    This software is provided 'as-is', without any express or implied warranty. In no event will the
+    authors be held liable for any damages arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose, including commercial
+    applications, and to alter it and redistribute it freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+       original software. If you use this software in a product, an acknowledgement in the product
+       documentation would be appreciated but is not required.
+    2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+       being the original software.
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef DEVECTOR_GAP_DEVECTOR_H
+#define DEVECTOR_GAP_DEVECTOR_H
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "devector.h"
+
+
+
+// A devector turned inside out: the free space is a single gap inside the buffer rather than two
+// regions around it. Inserting or erasing at the gap is O(1) amortized, moving the gap relocates
+// only the elements between the old and new gap position.
+template<class T, class Allocator = std::allocator<T>>
+class gap_devector {
+private:
+    typedef std::allocator_traits<Allocator> alloc_traits;
+    typedef gap_devector<T, Allocator> V;
+
+    template<class Ref, class Container>
+    class iterator_impl {
+    public:
+        typedef std::random_access_iterator_tag          iterator_category;
+        typedef T                                        value_type;
+        typedef typename alloc_traits::difference_type   difference_type;
+        typedef typename std::remove_reference<Ref>::type* pointer;
+        typedef Ref                                      reference;
+
+        iterator_impl() noexcept : c(nullptr), i(0) { }
+        iterator_impl(Container* container, difference_type index) noexcept
+        : c(container), i(index) { }
+
+        // iterator to const_iterator, but not the other way around.
+        template<class R, class C, class = typename std::enable_if<
+            std::is_convertible<C*, Container*>::value
+        >::type>
+        iterator_impl(const iterator_impl<R, C>& other) noexcept : c(other.c), i(other.i) { }
+
+        reference operator*()  const noexcept { return (*c)[i]; }
+        pointer   operator->() const noexcept { return std::addressof((*c)[i]); }
+        reference operator[](difference_type n) const noexcept { return (*c)[i + n]; }
+
+        iterator_impl& operator++()    noexcept { ++i; return *this; }
+        iterator_impl& operator--()    noexcept { --i; return *this; }
+        iterator_impl  operator++(int) noexcept { iterator_impl r(*this); ++i; return r; }
+        iterator_impl  operator--(int) noexcept { iterator_impl r(*this); --i; return r; }
+        iterator_impl& operator+=(difference_type n) noexcept { i += n; return *this; }
+        iterator_impl& operator-=(difference_type n) noexcept { i -= n; return *this; }
+
+        friend iterator_impl operator+(iterator_impl it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend iterator_impl operator+(difference_type n, iterator_impl it) noexcept {
+            return it += n;
+        }
+
+        friend iterator_impl operator-(iterator_impl it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        // Templates so that any mix of iterator and const_iterator is an exact match, rather than
+        // going through a conversion. Only meaningful for iterators into the same container.
+        template<class R, class C>
+        difference_type operator-(const iterator_impl<R, C>& other) const noexcept {
+            return i - other.i;
+        }
+
+        template<class R, class C>
+        bool operator==(const iterator_impl<R, C>& other) const noexcept { return i == other.i; }
+
+        template<class R, class C>
+        bool operator!=(const iterator_impl<R, C>& other) const noexcept { return i != other.i; }
+
+        template<class R, class C>
+        bool operator<(const iterator_impl<R, C>& other) const noexcept { return i < other.i; }
+
+        template<class R, class C>
+        bool operator>(const iterator_impl<R, C>& other) const noexcept { return i > other.i; }
+
+        template<class R, class C>
+        bool operator<=(const iterator_impl<R, C>& other) const noexcept { return i <= other.i; }
+
+        template<class R, class C>
+        bool operator>=(const iterator_impl<R, C>& other) const noexcept { return i >= other.i; }
+
+    private:
+        template<class, class> friend class iterator_impl;
+        friend class gap_devector;
+
+        Container* c;
+        difference_type i;
+    };
+
+public:
+    // Typedefs.
+    typedef T                                          value_type;
+    typedef Allocator                                  allocator_type;
+    typedef typename alloc_traits::size_type           size_type;
+    typedef typename alloc_traits::difference_type     difference_type;
+    typedef typename alloc_traits::pointer             pointer;
+    typedef typename alloc_traits::const_pointer       const_pointer;
+    typedef T&                                         reference;
+    typedef const T&                                   const_reference;
+    typedef iterator_impl<T&, V>                       iterator;
+    typedef iterator_impl<const T&, const V>           const_iterator;
+    typedef std::reverse_iterator<iterator>            reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>      const_reverse_iterator;
+
+    // Construct/copy/destroy.
+    ~gap_devector() noexcept { destruct(); }
+
+    gap_devector() noexcept(std::is_nothrow_default_constructible<Allocator>::value) : impl() {
+        impl.null();
+    }
+
+    explicit gap_devector(const Allocator& alloc) noexcept : impl(alloc) { impl.null(); }
+
+    template<class InputIterator>
+    gap_devector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator())
+    : impl(alloc) {
+        impl.null();
+        try { while (first != last) push_back(*first++); }
+        catch (...) { destruct(); throw; }
+    }
+
+    gap_devector(const V& other)
+    : impl(alloc_traits::select_on_container_copy_construction(other.impl.alloc())) {
+        init_copy(other);
+    }
+
+    gap_devector(const V& other, const Allocator& alloc) : impl(alloc) { init_copy(other); }
+
+    gap_devector(V&& other) noexcept : impl(std::move(other.impl.alloc())) {
+        impl.storage() = other.impl.storage();
+        other.impl.null();
+    }
+
+    gap_devector(std::initializer_list<T> il, const Allocator& alloc = Allocator())
+    : gap_devector(il.begin(), il.end(), alloc) { }
+
+    V& operator=(const V& other) {
+        if (this != &other) {
+            clear();
+            copy_assign_propagate_dispatcher(
+                other,
+                std::integral_constant<bool,
+                    alloc_traits::propagate_on_container_copy_assignment::value
+                >()
+            );
+
+            reserve(other.size());
+            for (const auto& x : other) emplace_back(x);
+        }
+
+        return *this;
+    }
+
+    V& operator=(V&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value) {
+        if (this != &other) {
+            move_assign_propagate_dispatcher(
+                std::move(other),
+                std::integral_constant<bool,
+                    alloc_traits::propagate_on_container_move_assignment::value
+                >()
+            );
+        }
+
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept { return impl; }
+
+    // Iterators.
+    iterator               begin()         noexcept { return iterator(this, 0);             }
+    const_iterator         begin()   const noexcept { return const_iterator(this, 0);       }
+    iterator               end()           noexcept { return iterator(this, size());        }
+    const_iterator         end()     const noexcept { return const_iterator(this, size());  }
+
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator(end());         }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end());   }
+    reverse_iterator       rend()          noexcept { return reverse_iterator(begin());       }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin()  const noexcept { return begin();  }
+    const_iterator         cend()    const noexcept { return end();    }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend();   }
+
+    // Capacity.
+    size_type max_size() const noexcept { return alloc_traits::max_size(impl); }
+    size_type size()     const noexcept { return capacity() - gap_size(); }
+    size_type capacity() const noexcept { return impl.end_storage - impl.begin_storage; }
+    size_type gap_size() const noexcept { return impl.end_gap - impl.begin_gap; }
+    bool      empty()    const noexcept { return size() == 0; }
+
+    void reserve(size_type n) {
+        if (n > max_size()) throw std::length_error("gap_devector");
+        if (capacity() >= n) return;
+
+        reallocate(n, gap_position());
+    }
+
+    void shrink_to_fit() {
+        if (gap_size() > 0) reallocate(size(), gap_position());
+    }
+
+    // Gap.
+    size_type gap_position() const noexcept { return impl.begin_gap - impl.begin_storage; }
+
+    // Moves the gap so that it starts directly before element pos. Only the elements between the
+    // old and new gap position are moved. Invalidates all references, but not iterators.
+    void move_gap(size_type pos) {
+        if (gap_size() == 0) {
+            impl.begin_gap = impl.end_gap = impl.begin_storage + pos;
+            return;
+        }
+
+        move_gap_dispatcher(
+            pos,
+            std::integral_constant<bool,
+                std::is_nothrow_move_constructible<T>::value &&
+                std::is_nothrow_move_assignable<T>::value
+            >()
+        );
+    }
+
+    // Indexing.
+    reference operator[](size_type i) noexcept {
+        return i < gap_position() ? impl.begin_storage[i] : impl.end_gap[i - gap_position()];
+    }
+
+    const_reference operator[](size_type i) const noexcept {
+        return i < gap_position() ? impl.begin_storage[i] : impl.end_gap[i - gap_position()];
+    }
+
+    reference at(size_type i) {
+        if (i >= size()) throw std::out_of_range("gap_devector");
+        return (*this)[i];
+    }
+
+    const_reference at(size_type i) const {
+        if (i >= size()) throw std::out_of_range("gap_devector");
+        return (*this)[i];
+    }
+
+    reference       front()       noexcept { return (*this)[0];          }
+    const_reference front() const noexcept { return (*this)[0];          }
+    reference       back()        noexcept { return (*this)[size() - 1]; }
+    const_reference back()  const noexcept { return (*this)[size() - 1]; }
+
+    // Moves the gap to the end to make the elements contiguous.
+    T* data() {
+        if (empty()) return nullptr;
+
+        move_gap(size());
+        return std::addressof(*impl.begin_storage);
+    }
+
+    // Modifiers.
+    void push_front(const T& x) { emplace(begin(), x); }
+    void push_front(T&& x)      { emplace(begin(), std::move(x)); }
+    void push_back(const T& x)  { emplace(end(), x); }
+    void push_back(T&& x)       { emplace(end(), std::move(x)); }
+    void pop_front()            { erase(begin()); }
+    void pop_back()             { erase(end() - 1); }
+
+    template<class... Args>
+    void emplace_front(Args&&... args) { emplace(begin(), std::forward<Args>(args)...); }
+
+    template<class... Args>
+    void emplace_back(Args&&... args) { emplace(end(), std::forward<Args>(args)...); }
+
+    // Inserts before position by moving the gap there. Repeated inserts at the returned iterator
+    // + 1 (typing) are O(1) amortized.
+    template<class... Args>
+    iterator emplace(const_iterator position, Args&&... args) {
+        // Construct first, args might alias an element of the gap_devector.
+        T tmp(std::forward<Args>(args)...);
+
+        if (gap_size() == 0) grow(1, position.i);
+        else                 move_gap(position.i);
+        alloc_traits::construct(impl, std::addressof(*impl.begin_gap), std::move(tmp));
+        ++impl.begin_gap; // We do this after constructing for strong exception safety.
+
+        return iterator(this, position.i);
+    }
+
+    iterator insert(const_iterator position, const T& t) { return emplace(position, t); }
+    iterator insert(const_iterator position, T&& t) { return emplace(position, std::move(t)); }
+
+    iterator insert(const_iterator position, size_type n, const T& t) {
+        T tmp(t);
+        if (gap_size() < n) grow(n, position.i);
+        else                move_gap(position.i);
+        alloc_insert_at_gap(n, [&]() -> const T& { return tmp; });
+        return iterator(this, position.i);
+    }
+
+    iterator insert(const_iterator position, std::initializer_list<T> il) {
+        return insert(position, il.begin(), il.end());
+    }
+
+    template<class InputIterator>
+    typename std::enable_if<
+        std::is_base_of<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category
+        >::value,
+    iterator>::type insert(const_iterator position, InputIterator first, InputIterator last) {
+        difference_type pos = position.i;
+        while (first != last) emplace(const_iterator(this, pos++), *first++);
+        return iterator(this, position.i);
+    }
+
+    // Erases by moving the gap to position and growing it over the erased elements. Repeated
+    // erases at the returned iterator (delete) or the one before it (backspace) are O(1).
+    iterator erase(const_iterator position) { return erase(position, position + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        move_gap(first.i);
+        for (difference_type n = last - first; n > 0; --n) {
+            alloc_traits::destroy(impl, std::addressof(*impl.end_gap++));
+        }
+
+        return iterator(this, first.i);
+    }
+
+    void swap(V& other)
+    noexcept(!alloc_traits::propagate_on_container_swap::value ||
+             detail::is_nothrow_swappable<Allocator>::value) {
+        using std::swap;
+
+        if (alloc_traits::propagate_on_container_swap::value) {
+            swap(impl.alloc(), other.impl.alloc());
+        }
+
+        swap(impl.storage(), other.impl.storage());
+    }
+
+    void clear() noexcept {
+        while (impl.begin_gap != impl.begin_storage) {
+            alloc_traits::destroy(impl, std::addressof(*--impl.begin_gap));
+        }
+
+        while (impl.end_gap != impl.end_storage) {
+            alloc_traits::destroy(impl, std::addressof(*impl.end_gap++));
+        }
+    }
+
+private:
+    struct ImplStorage {
+        void null() {
+            begin_storage = end_storage = nullptr;
+            begin_gap = end_gap = nullptr;
+        }
+
+        pointer begin_storage; // storage[0]
+        pointer end_storage; // storage[n] (one-past-end)
+        pointer begin_gap; // first free slot, one past the elements before the gap
+        pointer end_gap; // one past the last free slot, first element after the gap
+    };
+
+    // Empty base class optimization.
+    struct Impl : ImplStorage, Allocator {
+        Impl() noexcept(std::is_nothrow_default_constructible<Allocator>::value) : Allocator() { }
+        explicit Impl(const Allocator& alloc) noexcept : Allocator(alloc) { }
+        explicit Impl(Allocator&& alloc) noexcept : Allocator(std::move(alloc)) { }
+
+        Allocator& alloc() { return *this; }
+        const Allocator& alloc() const { return *this; }
+
+        ImplStorage& storage() { return *this; }
+        const ImplStorage& storage() const { return *this; }
+    } impl;
+
+    // Deallocates the stored memory. Does not leave the gap_devector in a valid state!
+    void deallocate() noexcept {
+        alloc_traits::deallocate(impl, impl.begin_storage, capacity());
+    }
+
+    // Deletes all elements and deallocates memory. Does not leave the gap_devector in a valid
+    // state.
+    void destruct() noexcept {
+        clear();
+        deallocate();
+    }
+
+    // Grow so that the gap can hold at least n elements and starts at gap_pos. Uses the same
+    // exponential growth as devector, with factor 1.5 (2 for small sizes).
+    void grow(size_type n, size_type gap_pos) {
+        size_type cap = capacity();
+        size_type alloc_size = std::max<size_type>(cap * (3 + (cap < 16)) / 2, size() + n);
+        reallocate(alloc_size, gap_pos);
+    }
+
+    // Reallocate to exactly alloc_size elements of storage, with the gap starting at gap_pos.
+    // Elements are moved directly to their new position, the gap is never moved separately.
+    void reallocate(size_type alloc_size, size_type gap_pos) {
+        size_type num_after = size() - gap_pos;
+
+        pointer new_storage = alloc_traits::allocate(impl, alloc_size);
+        pointer new_end_gap = new_storage + alloc_size - num_after;
+
+        pointer new_begin_gap = new_storage;
+        try {
+            new_begin_gap = alloc_uninitialized_copy(
+                detail::make_move_if_noexcept_iterator(begin()),
+                detail::make_move_if_noexcept_iterator(begin() + gap_pos),
+                new_storage);
+            alloc_uninitialized_copy(detail::make_move_if_noexcept_iterator(begin() + gap_pos),
+                                     detail::make_move_if_noexcept_iterator(end()),
+                                     new_end_gap);
+        } catch (...) {
+            while (new_begin_gap != new_storage) {
+                alloc_traits::destroy(impl, std::addressof(*--new_begin_gap));
+            }
+
+            alloc_traits::deallocate(impl, new_storage, alloc_size);
+            throw;
+        }
+
+        destruct();
+        impl.begin_storage = new_storage;
+        impl.end_storage = new_storage + alloc_size;
+        impl.begin_gap = new_begin_gap;
+        impl.end_gap = new_end_gap;
+    }
+
+    // Constructs n elements from next() at the start of the gap, which must be large enough.
+    // Strong exception guarantee, cleans up if an exception occurs.
+    template<class Generator>
+    void alloc_insert_at_gap(size_type n, Generator next) {
+        pointer first = impl.begin_gap;
+
+        try {
+            while (n--) {
+                alloc_traits::construct(impl, std::addressof(*impl.begin_gap), next());
+                ++impl.begin_gap;
+            }
+        } catch (...) {
+            while (impl.begin_gap != first) {
+                alloc_traits::destroy(impl, std::addressof(*--impl.begin_gap));
+            }
+
+            throw;
+        }
+    }
+
+    // Copies from the range [first, last) into the uninitialized range starting at d_first. Strong
+    // exception guarantee, cleans up if an exception occurs.
+    template<class InputIterator>
+    pointer alloc_uninitialized_copy(InputIterator first, InputIterator last, pointer d_first) {
+        pointer current = d_first;
+
+        try {
+            while (first != last) {
+                alloc_traits::construct(impl, std::addressof(*current++), *first++);
+            }
+        } catch (...) {
+            while (d_first != current) alloc_traits::destroy(impl, std::addressof(*d_first++));
+            throw;
+        }
+
+        return current;
+    }
+
+    // Moves [first, last) into the uninitialized range starting at d_first, for a T that does not
+    // throw when moved. std::allocator::construct is placement new, so for it we can leave this to
+    // std::uninitialized_copy, which is a memmove for trivial types.
+    void alloc_uninitialized_move(pointer first, pointer last, pointer d_first) noexcept {
+        alloc_uninitialized_move_dispatcher(
+            first, last, d_first,
+            std::integral_constant<bool, std::is_same<Allocator, std::allocator<T>>::value>()
+        );
+    }
+
+    void alloc_uninitialized_move_dispatcher(pointer first, pointer last, pointer d_first,
+                                             std::true_type) noexcept {
+        std::uninitialized_copy(std::make_move_iterator(first), std::make_move_iterator(last),
+                                d_first);
+    }
+
+    void alloc_uninitialized_move_dispatcher(pointer first, pointer last, pointer d_first,
+                                             std::false_type) noexcept {
+        alloc_uninitialized_copy(std::make_move_iterator(first), std::make_move_iterator(last),
+                                 d_first);
+    }
+
+    // Helper functions for move_gap on a non-empty gap. Second argument is whether T can be moved
+    // without throwing. If so, up to gap_size() elements are moved into the gap and the rest are
+    // shifted with std::move, which is a memmove for trivial types. Otherwise one element at a
+    // time is moved into uninitialized gap space, so the gap_devector is valid at every step.
+    void move_gap_dispatcher(size_type pos, std::true_type) noexcept {
+        size_type gap_pos = gap_position();
+        pointer b = impl.begin_gap;
+        pointer e = impl.end_gap;
+
+        if (pos < gap_pos) {
+            size_type k = gap_pos - pos;
+            size_type m = std::min(k, gap_size());
+            alloc_uninitialized_move(b - m, b, e - m);
+            std::move_backward(b - k, b - m, e - m);
+            for (pointer p = b - k; p != b - k + m; ++p) {
+                alloc_traits::destroy(impl, std::addressof(*p));
+            }
+
+            impl.begin_gap = b - k;
+            impl.end_gap = e - k;
+        } else if (pos > gap_pos) {
+            size_type k = pos - gap_pos;
+            size_type m = std::min(k, gap_size());
+            alloc_uninitialized_move(e, e + m, b);
+            std::move(e + m, e + k, b + m);
+            for (pointer p = e + k - m; p != e + k; ++p) {
+                alloc_traits::destroy(impl, std::addressof(*p));
+            }
+
+            impl.begin_gap = b + k;
+            impl.end_gap = e + k;
+        }
+    }
+
+    void move_gap_dispatcher(size_type pos, std::false_type) {
+        size_type gap_pos = gap_position();
+
+        // The destination is always uninitialized gap space, and we construct before moving the
+        // cursors for strong exception safety.
+        while (pos < gap_pos) {
+            alloc_traits::construct(impl, std::addressof(*(impl.end_gap - 1)),
+                                    std::move_if_noexcept(*(impl.begin_gap - 1)));
+            alloc_traits::destroy(impl, std::addressof(*--impl.begin_gap));
+            --impl.end_gap;
+            --gap_pos;
+        }
+
+        while (pos > gap_pos) {
+            alloc_traits::construct(impl, std::addressof(*impl.begin_gap),
+                                    std::move_if_noexcept(*impl.end_gap));
+            alloc_traits::destroy(impl, std::addressof(*impl.end_gap++));
+            ++impl.begin_gap;
+            ++gap_pos;
+        }
+    }
+
+    // Initializes with a copy of other, without a gap.
+    void init_copy(const V& other) {
+        impl.null();
+        if (other.empty()) return;
+
+        impl.begin_storage = impl.begin_gap = alloc_traits::allocate(impl, other.size());
+        impl.end_storage = impl.end_gap = impl.begin_storage + other.size();
+
+        const_iterator it = other.begin();
+        try {
+            alloc_insert_at_gap(other.size(), [&]() -> const T& { return *it++; });
+        } catch (...) { deallocate(); throw; }
+    }
+
+    // Helper functions for copy assignment, called on an empty gap_devector. Second argument is
+    // alloc_traits::propagate_on_container_copy_assignment::value.
+    void copy_assign_propagate_dispatcher(const V& other, std::true_type) {
+        if (impl.alloc() != other.impl.alloc()) {
+            deallocate();
+            impl.null();
+        }
+
+        impl.alloc() = other.impl.alloc();
+    }
+
+    void copy_assign_propagate_dispatcher(const V&, std::false_type) { }
+
+    // Helper functions for move assignment. Second argument is
+    // alloc_traits::propagate_on_container_move_assignment::value.
+    void move_assign_propagate_dispatcher(V&& other, std::true_type) noexcept {
+        destruct();
+        impl.alloc() = std::move(other.impl.alloc());
+        impl.storage() = other.impl.storage();
+        other.impl.null();
+    }
+
+    void move_assign_propagate_dispatcher(V&& other, std::false_type) {
+        if (impl.alloc() == other.impl.alloc()) {
+            destruct();
+            impl.storage() = other.impl.storage();
+            other.impl.null();
+            return;
+        }
+
+        clear();
+        reserve(other.size());
+        for (auto& x : other) emplace_back(std::move(x));
+        other.clear();
+    }
+};
+
+
+// Comparison operators.
+template<class T, class Allocator>
+inline bool operator==(const gap_devector<T, Allocator>& lhs,
+                       const gap_devector<T, Allocator>& rhs) {
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<class T, class Allocator>
+inline bool operator< (const gap_devector<T, Allocator>& lhs,
+                       const gap_devector<T, Allocator>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<class T, class Allocator>
+inline bool operator!=(const gap_devector<T, Allocator>& lhs,
+                       const gap_devector<T, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<class T, class Allocator>
+inline bool operator> (const gap_devector<T, Allocator>& lhs,
+                       const gap_devector<T, Allocator>& rhs) {
+    return rhs < lhs;
+}
+
+template<class T, class Allocator>
+inline bool operator<=(const gap_devector<T, Allocator>& lhs,
+                       const gap_devector<T, Allocator>& rhs) {
+    return !(rhs < lhs);
+}
+
+template<class T, class Allocator>
+inline bool operator>=(const gap_devector<T, Allocator>& lhs,
+                       const gap_devector<T, Allocator>& rhs) {
+    return !(lhs < rhs);
+}
+
+template<class T, class Allocator>
+inline void swap(gap_devector<T, Allocator>& lhs, gap_devector<T, Allocator>& rhs)
+noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+#endif
@@ -0,0 +1,289 @@
+/*
+    Copyright (c) 2014 Orson Peters
+
+    This software is provided 'as-is', without any express or implied warranty. In no event will the
+    authors be held liable for any damages arising from the use of this software.
+
+    Permission is granted to anyone to use this software for any purpose, including commercial
+    applications, and to alter it and redistribute it freely, subject to the following restrictions:
+
+    1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+       original software. If you use this software in a product, an acknowledgement in the product
+       documentation would be appreciated but is not required.
+    2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+       being the original software.
+    3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef DEVECTOR_HUGE_PAGE_ALLOCATOR_H
+#define DEVECTOR_HUGE_PAGE_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+// Aligned heap allocation: posix_memalign on POSIX systems, _aligned_malloc on Windows and C++17
+// aligned operator new elsewhere.
+#if defined(_WIN32)
+    #include <malloc.h>
+    #define DEVECTOR_HUGE_PAGE_HEAP_WIN32
+#elif defined(__unix__) || defined(__APPLE__)
+    #define DEVECTOR_HUGE_PAGE_HEAP_POSIX
+#elif defined(__cpp_aligned_new) && __cpp_aligned_new >= 201606L
+    #define DEVECTOR_HUGE_PAGE_HEAP_ALIGNED_NEW
+#else
+    #error "huge_page_allocator: no aligned allocation function available on this platform"
+#endif
+
+
+
+// Settings for huge_page_allocator. Allocations of at least threshold bytes are mapped directly
+// and backed by huge pages, smaller ones come from the heap.
+struct huge_page_options {
+    std::size_t threshold = std::size_t(2) << 20;
+
+    // Use MAP_HUGETLB, which needs huge pages reserved by the administrator (vm.nr_hugepages).
+    // Falls back to transparent huge pages if none are available.
+    bool hugetlb = false;
+
+    // Bind mapped memory to this NUMA node with mbind, or -1 to use the default policy. Binding
+    // is best effort, nodes that do not fit in an unsigned long mask are ignored.
+    int numa_node = -1;
+
+    // Have devector place its first element on an Alignment boundary whenever it reallocates, so
+    // scans start on a cache line (or SIMD width). Costs up to Alignment bytes of free space.
+    bool align_cursor = false;
+
+    friend bool operator==(const huge_page_options& lhs, const huge_page_options& rhs) {
+        return lhs.threshold == rhs.threshold && lhs.hugetlb == rhs.hugetlb &&
+               lhs.numa_node == rhs.numa_node && lhs.align_cursor == rhs.align_cursor;
+    }
+
+    friend bool operator!=(const huge_page_options& lhs, const huge_page_options& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+
+// Allocator for large devectors. All storage is aligned to Alignment bytes (a cache line by
+// default, or pick the SIMD width). Large allocations are rounded up to whole huge pages to reduce
+// TLB misses. The rounding is reported through allocate_at_least, so devector uses it as capacity
+// rather than wasting it. Huge pages and NUMA binding are only available on Linux, elsewhere all
+// memory comes from the heap.
+template<class T, std::size_t Alignment = 64>
+class huge_page_allocator {
+    static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0,
+                  "huge_page_allocator: Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T),
+                  "huge_page_allocator: Alignment must be at least alignof(T)");
+
+public:
+    typedef T           value_type;
+    typedef std::size_t size_type;
+
+    template<class U>
+    struct rebind { typedef huge_page_allocator<U, Alignment> other; };
+
+#if defined(__cpp_lib_allocate_at_least) && __cpp_lib_allocate_at_least >= 202302L
+    typedef std::allocation_result<T*, size_type> allocation_result;
+#else
+    struct allocation_result {
+        T* ptr;
+        size_type count;
+    };
+#endif
+
+    static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+    huge_page_allocator() noexcept : opts() { }
+    explicit huge_page_allocator(const huge_page_options& opts) noexcept : opts(opts) { }
+
+    template<class U>
+    huge_page_allocator(const huge_page_allocator<U, Alignment>& other) noexcept
+    : opts(other.options()) { }
+
+    const huge_page_options& options() const noexcept { return opts; }
+
+    // Used by devector when options().align_cursor is set, in elements.
+    size_type cursor_alignment() const noexcept {
+        return opts.align_cursor && Alignment % sizeof(T) == 0 ? Alignment / sizeof(T) : 1;
+    }
+
+    T* allocate(size_type n) { return allocate_at_least(n).ptr; }
+
+    allocation_result allocate_at_least(size_type n) {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) throw std::bad_alloc();
+        std::size_t bytes = n * sizeof(T);
+
+#if defined(__linux__)
+        if (is_mapped(bytes)) {
+            std::size_t len = mapped_length(bytes);
+            return {static_cast<T*>(map(len)), len / sizeof(T)};
+        }
+#endif
+
+        return {static_cast<T*>(heap_allocate(bytes ? bytes : 1)), n};
+    }
+
+    // What allocate_at_least(n) would return as count, without allocating.
+    size_type good_size(size_type n) const noexcept {
+#if defined(__linux__)
+        if (n <= std::numeric_limits<size_type>::max() / sizeof(T) && is_mapped(n * sizeof(T))) {
+            return mapped_length(n * sizeof(T)) / sizeof(T);
+        }
+#endif
+
+        return n;
+    }
+
+    // Used by devector's shrink_to_fit, shrink_front and shrink_back. Unmaps the huge pages of a
+    // mapped allocation of count elements that are not needed for n elements, and returns the new
+    // count. Returns count if the allocation is not mapped, or would no longer be at n elements.
+    size_type shrink_in_place(T* p, size_type count, size_type n) noexcept {
+#if defined(__linux__)
+        std::size_t bytes = count * sizeof(T);
+        if (n <= count && is_mapped(bytes) && is_mapped(n * sizeof(T))) {
+            std::size_t len = mapped_length(bytes);
+            std::size_t new_len = mapped_length(n * sizeof(T));
+            if (new_len < len) munmap(reinterpret_cast<char*>(p) + new_len, len - new_len);
+            return std::min<size_type>(count, new_len / sizeof(T));
+        }
+#else
+        (void) p; (void) n;
+#endif
+
+        return count;
+    }
+
+    void deallocate(T* p, size_type n) noexcept {
+#if defined(__linux__)
+        std::size_t bytes = n * sizeof(T);
+        if (is_mapped(bytes)) {
+            munmap(p, mapped_length(bytes));
+            return;
+        }
+#else
+        (void) n;
+#endif
+
+        heap_deallocate(p);
+    }
+
+    template<class U>
+    bool operator==(const huge_page_allocator<U, Alignment>& other) const noexcept {
+        return opts == other.options();
+    }
+
+    template<class U>
+    bool operator!=(const huge_page_allocator<U, Alignment>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    huge_page_options opts;
+
+    static void* heap_allocate(std::size_t bytes) {
+#if defined(DEVECTOR_HUGE_PAGE_HEAP_WIN32)
+        void* p = _aligned_malloc(bytes, Alignment);
+        if (!p) throw std::bad_alloc();
+        return p;
+#elif defined(DEVECTOR_HUGE_PAGE_HEAP_POSIX)
+        // posix_memalign requires at least the alignment of a pointer.
+        void* p = nullptr;
+        std::size_t align = Alignment < sizeof(void*) ? sizeof(void*) : Alignment;
+        if (posix_memalign(&p, align, bytes) != 0) throw std::bad_alloc();
+        return p;
+#else
+        return ::operator new(bytes, std::align_val_t(Alignment));
+#endif
+    }
+
+    static void heap_deallocate(void* p) noexcept {
+#if defined(DEVECTOR_HUGE_PAGE_HEAP_WIN32)
+        _aligned_free(p);
+#elif defined(DEVECTOR_HUGE_PAGE_HEAP_POSIX)
+        std::free(p);
+#else
+        ::operator delete(p, std::align_val_t(Alignment));
+#endif
+    }
+
+#if defined(__linux__)
+    // Whether an allocation of this many bytes is mapped rather than taken from the heap. Depends
+    // only on the size, so deallocate can tell without storing anything.
+    bool is_mapped(std::size_t bytes) const noexcept { return bytes >= opts.threshold; }
+
+    static std::size_t mapped_length(std::size_t bytes) noexcept {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+    // Maps len bytes (a multiple of huge_page_size) aligned to huge_page_size.
+    void* map(std::size_t len) const {
+        void* p = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+        if (opts.hugetlb) {
+            p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+
+        if (p == MAP_FAILED) {
+            // Over-allocate and trim, transparent huge pages need a huge page aligned range.
+            std::size_t padded = len + huge_page_size;
+            void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw);
+            std::uintptr_t aligned = (addr + huge_page_size - 1) & ~(huge_page_size - 1);
+            std::size_t head = aligned - addr;
+            std::size_t tail = padded - head - len;
+            if (head) munmap(raw, head);
+            if (tail) munmap(reinterpret_cast<void*>(aligned + len), tail);
+            p = reinterpret_cast<void*>(aligned);
+
+#if defined(MADV_HUGEPAGE)
+            madvise(p, len, MADV_HUGEPAGE);
+#endif
+        }
+
+        bind_numa_node(p, len);
+        return p;
+    }
+
+    // Called before the memory is touched, so every page gets allocated on the chosen node.
+    void bind_numa_node(void* p, std::size_t len) const noexcept {
+#if defined(SYS_mbind)
+        // The kernel ignores the last bit of the mask, so the highest bit is not usable.
+        const int max_node = sizeof(unsigned long) * 8 - 2;
+        if (opts.numa_node < 0 || opts.numa_node > max_node) return;
+
+        const int mpol_bind = 2; // MPOL_BIND from <numaif.h>, which is part of libnuma.
+        unsigned long nodemask = 1UL << opts.numa_node;
+        syscall(SYS_mbind, p, len, mpol_bind, &nodemask, sizeof(nodemask) * 8, 0);
+#else
+        (void) p; (void) len;
+#endif
+    }
+#endif
+};
+
+// Redundant and deprecated since C++17, where static constexpr members are implicitly inline.
+#if !defined(__cpp_inline_variables) || __cpp_inline_variables < 201606L
+template<class T, std::size_t Alignment>
+constexpr std::size_t huge_page_allocator<T, Alignment>::huge_page_size;
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+/*
+    Checks that devector keeps the extra memory an allocator reports through allocate_at_least,
+    gives it to the end that is growing, and deallocates with the count that was returned.
+
+    g++ -std=c++11 -I.. allocate_at_least_test.cpp -o at_least_test && ./at_least_test
+*/
+
+#undef NDEBUG
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "devector.h"
+
+
+// Every live allocation and the count it was returned with.
+static std::map<void*, std::size_t> live;
+static std::size_t last_n = 0;
+static std::size_t last_count = 0;
+
+// Hands out 7 more elements than requested, plus rounding up to a multiple of 4.
+template<class T>
+struct slack_allocator {
+    typedef T value_type;
+
+    struct result { T* ptr; std::size_t count; };
+
+    slack_allocator() = default;
+    template<class U> slack_allocator(const slack_allocator<U>&) { }
+
+    result allocate_at_least(std::size_t n) {
+        std::size_t count = (n + 7 + 3) / 4 * 4;
+        T* p = std::allocator<T>().allocate(count);
+        live[p] = count;
+        last_n = n;
+        last_count = count;
+        return {p, count};
+    }
+
+    T* allocate(std::size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        live[p] = n;
+        return p;
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        assert(live.count(p) && live[p] == n);
+        live.erase(p);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const slack_allocator&) const { return true; }
+    bool operator!=(const slack_allocator&) const { return false; }
+};
+
+typedef devector<std::string, slack_allocator<std::string>> V;
+
+std::size_t free_front(const V& d) { return d.capacity_front() - d.size(); }
+std::size_t free_back(const V& d) { return d.capacity_back() - d.size(); }
+
+void test_push_back() {
+    V d;
+    for (int i = 0; i < 1000; ++i) {
+        std::size_t before = d.capacity();
+        d.push_back(std::to_string(i));
+
+        if (d.capacity() != before) {
+            // All of the surplus went to the back, none to the front.
+            assert(d.capacity() == last_count);
+            assert(free_front(d) == 0);
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i) assert(d[i] == std::to_string(i));
+}
+
+void test_push_front() {
+    V d;
+    for (int i = 0; i < 1000; ++i) {
+        std::size_t before = d.capacity();
+        d.push_front(std::to_string(i));
+
+        if (d.capacity() != before) {
+            assert(d.capacity() == last_count);
+            assert(free_back(d) == 0);
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i) assert(d[i] == std::to_string(999 - i));
+}
+
+// Growing one end after the other. The end that is not growing keeps exactly the free space that
+// was asked for, half of what it had, and the growing end gets all of the surplus.
+void test_alternating() {
+    V d;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            std::size_t front = free_front(d);
+            std::size_t before = d.capacity();
+            d.push_back("back");
+
+            if (d.capacity() != before) {
+                assert(d.capacity() == last_count);
+                assert(free_front(d) == front / 2);
+                assert(free_back(d) >= last_count - last_n);
+            }
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            std::size_t back = free_back(d);
+            std::size_t before = d.capacity();
+            d.push_front("front");
+
+            if (d.capacity() != before) {
+                assert(d.capacity() == last_count);
+                assert(free_back(d) == back / 2);
+                assert(free_front(d) >= last_count - last_n);
+            }
+        }
+    }
+
+    assert(d.size() == 2000 && d.front() == "front" && d.back() == "back");
+}
+
+void test_reserve() {
+    V d;
+    d.reserve_back(20);
+    assert(d.capacity() == last_count && last_count > 20);
+    assert(free_front(d) == 0 && free_back(d) == last_count);
+
+    d.push_back("x");
+    d.reserve_front(30);
+    assert(d.capacity() == last_count && free_back(d) == last_n - 30);
+    assert(free_front(d) == last_count - last_n + 29);
+
+    d.shrink_to_fit();
+    assert(d.capacity() == last_count && free_front(d) == 0 && free_back(d) == last_count - 1);
+    assert(d.size() == 1 && d.front() == "x");
+}
+
+int main() {
+    test_push_back();
+    test_push_front();
+    test_alternating();
+    test_reserve();
+
+    // Every allocation was returned with its count.
+    assert(live.empty());
+    std::puts("ok");
+}
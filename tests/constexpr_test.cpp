@@ -0,0 +1,111 @@
+/*
+    Checks that devector can be used in constant expressions. Everything here is evaluated by the
+    compiler, so the test passes if it compiles.
+
+    g++ -std=c++20 -I.. constexpr_test.cpp -o constexpr_test && ./constexpr_test
+*/
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+
+#include "devector.h"
+
+#if !defined(__cpp_constexpr_dynamic_alloc) || __cpp_constexpr_dynamic_alloc < 201907L
+    #error "constexpr_test needs C++20 constexpr allocation"
+#endif
+
+
+// A lookup table built by growing at both ends.
+constexpr std::array<int, 8> signed_squares() {
+    devector<int> d;
+    for (int i = 0; i < 4; ++i) {
+        d.push_back(i * i);
+        d.push_front(-(i + 1) * (i + 1));
+    }
+
+    std::array<int, 8> r{};
+    std::copy(d.begin(), d.end(), r.begin());
+    return r;
+}
+
+constexpr std::array<int, 8> squares = signed_squares();
+static_assert(squares[0] == -16 && squares[3] == -1, "");
+static_assert(squares[4] == 0 && squares[7] == 9, "");
+
+
+constexpr std::array<int, 16> edited() {
+    devector<int> d;
+    for (int i = 0; i < 8; ++i) {
+        d.push_back(i);
+        d.push_front(-i);
+    }
+
+    d.insert(d.begin() + 3, 100);
+    d.insert(d.end() - 2, 200);
+    d.erase(d.begin() + 1);
+    d.insert(d.begin() + 5, 2, 7);
+    d.erase(d.begin(), d.begin() + 2);
+
+    devector<int> c(d);
+    c.shrink_to_fit();
+    devector<int> m(std::move(c));
+    m.reserve(5, 50);
+    m.resize_front(20, 1);
+    m.resize(16);
+
+    std::array<int, 16> r{};
+    std::copy(m.begin(), m.end(), r.begin());
+    return r;
+}
+
+constexpr std::array<int, 16> edits = edited();
+static_assert(edits[0] == 1 && edits[2] == 1 && edits[3] == 100 && edits[4] == -4, "");
+static_assert(edits[6] == 7 && edits[7] == 7 && edits[8] == -2 && edits[15] == 4, "");
+
+
+constexpr bool capacity() {
+    devector<int> d;
+    d.reserve(4, 8);
+    bool reserved = d.capacity_front() >= 4 && d.capacity_back() >= 8;
+
+    d.resize(3, 5);
+    d.shrink_to_fit();
+    bool shrunk = d.capacity() == 3 && d.size() == 3;
+
+    d.clear();
+    d.shrink_to_fit();
+    return reserved && shrunk && d.capacity() == 0;
+}
+
+static_assert(capacity(), "");
+
+
+constexpr bool strings() {
+    devector<std::string> d;
+    d.push_back("world");
+    d.push_front("hello");
+    d.insert(d.begin() + 1, ", ");
+    d.emplace_back(3, '!');
+
+    std::string joined;
+    for (const std::string& s : d) joined += s;
+    d.erase(d.begin() + 1, d.end());
+    return joined == "hello, world!!!" && d.size() == 1 && d.front() == "hello";
+}
+
+static_assert(strings(), "");
+
+
+constexpr bool comparisons() {
+    devector<int> a{1, 2, 3};
+    devector<int> b{1, 2, 4};
+    devector<int> c(a);
+    return a < b && a != b && a == c && b >= c;
+}
+
+static_assert(comparisons(), "");
+
+
+int main() { }
@@ -0,0 +1,255 @@
+/*
+    Compares flat_set and flat_map against std::set and std::map, and the devector insert, emplace
+    and erase they are built on against std::vector, under random operations.
+
+    g++ -std=c++14 -I.. flat_map_test.cpp -o flat_map_test && ./flat_map_test
+*/
+
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "devector.h"
+#include "flat_map.h"
+
+
+static std::mt19937 rng(42);
+
+template<class A, class B>
+bool same(const A& a, const B& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+std::vector<int> random_keys(std::size_t n) {
+    std::vector<int> keys(n);
+    for (int& k : keys) k = int(rng() % 500);
+    return keys;
+}
+
+void test_flat_set() {
+    flat_set<int> s;
+    std::set<int> ref;
+
+    for (int round = 0; round < 3000; ++round) {
+        int key = int(rng() % 500);
+
+        switch (rng() % 6) {
+        case 0: {
+            auto r = s.insert(key);
+            auto ref_r = ref.insert(key);
+            assert(r.second == ref_r.second && *r.first == key);
+            break;
+        }
+
+        case 1: {
+            // Duplicates within the range and with existing keys.
+            std::vector<int> keys = random_keys(rng() % 40);
+            s.insert(keys.begin(), keys.end());
+            ref.insert(keys.begin(), keys.end());
+            break;
+        }
+
+        case 2: {
+            std::vector<int> keys = random_keys(20);
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            s.insert(sorted_unique, keys.begin(), keys.end());
+            ref.insert(keys.begin(), keys.end());
+            break;
+        }
+
+        case 3:
+            assert(s.erase(key) == ref.erase(key));
+            break;
+
+        case 4:
+            if (!s.empty()) {
+                flat_set<int>::iterator it = s.begin() + rng() % s.size();
+                ref.erase(*it);
+                s.erase(it);
+            }
+            break;
+
+        case 5:
+            assert((s.lower_bound(key) == s.end()) == (ref.lower_bound(key) == ref.end()));
+            assert((s.upper_bound(key) == s.end()) == (ref.upper_bound(key) == ref.end()));
+            if (s.lower_bound(key) != s.end()) assert(*s.lower_bound(key) == *ref.lower_bound(key));
+            if (s.upper_bound(key) != s.end()) assert(*s.upper_bound(key) == *ref.upper_bound(key));
+            assert(s.count(key) == ref.count(key));
+            assert((s.find(key) != s.end()) == (ref.find(key) != ref.end()));
+            break;
+        }
+
+        assert(same(s, ref));
+    }
+
+    // Append-mostly bulk inserts skip the merge.
+    flat_set<int> a;
+    std::set<int> a_ref;
+    for (int i = 0; i < 100; ++i) {
+        std::vector<int> keys = {10 * i + 3, 10 * i + 1, 10 * i + 2, 10 * i + 1};
+        a.insert(keys.begin(), keys.end());
+        a_ref.insert(keys.begin(), keys.end());
+        assert(same(a, a_ref));
+    }
+}
+
+void test_flat_map() {
+    flat_map<int, std::string> m;
+    std::map<int, std::string> ref;
+
+    for (int round = 0; round < 3000; ++round) {
+        int key = int(rng() % 300);
+        std::string value = std::to_string(round);
+
+        switch (rng() % 6) {
+        case 0: {
+            auto r = m.emplace(key, value);
+            auto ref_r = ref.emplace(key, value);
+            assert(r.second == ref_r.second && r.first->second == ref_r.first->second);
+            break;
+        }
+
+        case 1:
+            m[key] += value;
+            ref[key] += value;
+            break;
+
+        case 2: {
+            auto r = m.try_emplace(key, value);
+            auto ref_r = ref.insert(std::make_pair(key, value));
+            assert(r.second == ref_r.second);
+            break;
+        }
+
+        case 3:
+            m.insert_or_assign(key, value);
+            ref[key] = value;
+            break;
+
+        case 4: {
+            // First occurrence wins, like repeated std::map::insert.
+            std::vector<std::pair<int, std::string>> values;
+            for (int k : random_keys(rng() % 30)) values.emplace_back(k % 300, value);
+            m.insert(values.begin(), values.end());
+            ref.insert(values.begin(), values.end());
+            break;
+        }
+
+        case 5:
+            assert(m.erase(key) == ref.erase(key));
+            break;
+        }
+
+        assert(m.size() == ref.size());
+        assert(std::equal(m.begin(), m.end(), ref.begin(),
+                          [](const std::pair<int, std::string>& a,
+                             const std::pair<const int, std::string>& b) {
+                              return a.first == b.first && a.second == b.second;
+                          }));
+    }
+
+    for (const auto& kv : ref) assert(m.at(kv.first) == kv.second);
+}
+
+void test_transparent() {
+    flat_set<std::string, std::less<>> s = {"pear", "apple", "fig", "apple"};
+    assert(s.size() == 3);
+    assert(s.find("fig") != s.end() && s.find("kiwi") == s.end());
+    assert(s.count("apple") == 1 && s.contains("pear"));
+    assert(*s.lower_bound("b") == "fig" && *s.upper_bound("fig") == "pear");
+    assert(s.equal_range("apple").first == s.begin());
+
+    flat_map<std::string, int, std::less<>> m;
+    m["one"] = 1;
+    m["two"] = 2;
+    assert(m.find("two")->second == 2 && m.count("three") == 0);
+}
+
+// Strings, so that use-after-move and double destruction show up under sanitizers.
+void test_devector() {
+    devector<std::string> d;
+    std::vector<std::string> ref;
+
+    for (int round = 0; round < 5000; ++round) {
+        std::size_t pos = rng() % (ref.size() + 1);
+        std::string value(rng() % 40, char('a' + round % 26));
+
+        switch (rng() % 7) {
+        case 0:
+            assert(*d.insert(d.begin() + pos, value) == value);
+            ref.insert(ref.begin() + pos, value);
+            break;
+
+        case 1:
+            d.emplace(d.begin() + pos, 3, 'x');
+            ref.emplace(ref.begin() + pos, 3, 'x');
+            break;
+
+        case 2: {
+            std::size_t n = rng() % 5;
+            d.insert(d.begin() + pos, n, value);
+            ref.insert(ref.begin() + pos, n, value);
+            break;
+        }
+
+        case 3: {
+            std::vector<std::string> values(rng() % 10, value);
+            d.insert(d.begin() + pos, values.begin(), values.end());
+            ref.insert(ref.begin() + pos, values.begin(), values.end());
+            break;
+        }
+
+        case 4:
+            // The argument aliases an element that the insertion moves or reallocates.
+            if (!ref.empty()) {
+                std::size_t i = rng() % ref.size();
+                d.insert(d.begin() + pos, d[i]);
+                ref.insert(ref.begin() + pos, std::string(ref[i]));
+            }
+            break;
+
+        case 5:
+        case 6:
+            if (!ref.empty()) {
+                std::size_t first = rng() % ref.size();
+                std::size_t n = std::min<std::size_t>(ref.size() - first, 8);
+                std::size_t last = first + rng() % (n + 1);
+                auto it = d.erase(d.cbegin() + first, d.cbegin() + last);
+                ref.erase(ref.begin() + first, ref.begin() + last);
+                assert(it - d.begin() == std::ptrdiff_t(first));
+            }
+            break;
+        }
+
+        assert(same(d, ref));
+    }
+
+    // Aliasing at both ends, where inserts grow instead of shifting.
+    devector<std::string> e = {"front", "middle", "back"};
+    std::vector<std::string> e_ref(e.begin(), e.end());
+    for (int i = 0; i < 50; ++i) {
+        e.insert(e.begin(), e.back());
+        e_ref.insert(e_ref.begin(), std::string(e_ref.back()));
+        e.insert(e.end(), e[1]);
+        e_ref.insert(e_ref.end(), std::string(e_ref[1]));
+        assert(same(e, e_ref));
+    }
+}
+
+int main() {
+    test_flat_set();
+    test_flat_map();
+    test_transparent();
+    test_devector();
+    std::puts("ok");
+}
@@ -0,0 +1,220 @@
+/*
+    Compares gap_devector against std::vector under random edits, for a type that moves without
+    throwing and for one whose move constructor may throw, which move the gap differently.
+
+    g++ -std=c++11 -I.. gap_devector_test.cpp -o gap_devector_test && ./gap_devector_test
+*/
+
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gap_devector.h"
+
+
+static std::mt19937 rng(42);
+
+// Copying throws once countdown reaches zero, moving is not noexcept so the gap is moved one
+// element at a time.
+static int countdown = -1;
+
+struct throwing {
+    int value;
+
+    throwing(int v) : value(v) { }
+    throwing(const throwing& other) : value(other.value) { tick(); }
+    throwing(throwing&& other) : value(other.value) { tick(); }
+    throwing& operator=(const throwing& other) { tick(); value = other.value; return *this; }
+    throwing& operator=(throwing&& other) { tick(); value = other.value; return *this; }
+
+    static void tick() {
+        if (countdown > 0 && --countdown == 0) throw std::runtime_error("throwing");
+    }
+
+    friend bool operator==(const throwing& a, const throwing& b) { return a.value == b.value; }
+};
+
+static_assert(std::is_nothrow_move_constructible<std::string>::value, "");
+static_assert(!std::is_nothrow_move_constructible<throwing>::value, "");
+
+template<class T>
+bool same(const gap_devector<T>& g, const std::vector<T>& ref) {
+    if (g.size() != ref.size()) return false;
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        if (!(g[i] == ref[i])) return false;
+    }
+
+    return std::equal(g.begin(), g.end(), ref.begin());
+}
+
+template<class T, class Make>
+void test_edits(Make make) {
+    gap_devector<T> g;
+    std::vector<T> ref;
+    std::size_t cursor = 0;
+
+    for (int round = 0; round < 5000; ++round) {
+        // Mostly edits next to the previous one, sometimes a jump.
+        if (rng() % 8 == 0) cursor = rng() % (ref.size() + 1);
+        cursor = std::min(cursor, ref.size());
+
+        switch (rng() % 8) {
+        case 0:
+        case 1:
+        case 2:
+            g.insert(g.begin() + cursor, make(round));
+            ref.insert(ref.begin() + cursor, make(round));
+            ++cursor;
+            break;
+
+        case 3: {
+            std::size_t n = rng() % 20;
+            g.insert(g.cbegin() + cursor, n, make(round));
+            ref.insert(ref.begin() + cursor, n, make(round));
+            break;
+        }
+
+        case 4:
+            if (cursor > 0) {
+                --cursor;
+                assert(g.erase(g.begin() + cursor) == g.begin() + cursor);
+                ref.erase(ref.begin() + cursor);
+            }
+            break;
+
+        case 5:
+            if (cursor < ref.size()) {
+                std::size_t n = std::min<std::size_t>(rng() % 10, ref.size() - cursor);
+                g.erase(g.begin() + cursor, g.begin() + cursor + n);
+                ref.erase(ref.begin() + cursor, ref.begin() + cursor + n);
+            }
+            break;
+
+        case 6:
+            // The argument aliases an element.
+            if (!ref.empty()) {
+                std::size_t i = rng() % ref.size();
+                g.insert(g.begin() + cursor, g[i]);
+                ref.insert(ref.begin() + cursor, T(ref[i]));
+            }
+            break;
+
+        case 7:
+            g.move_gap(rng() % (ref.size() + 1));
+            assert(g.size() == ref.size());
+            break;
+        }
+
+        assert(g.gap_position() <= g.size());
+        assert(g.size() + g.gap_size() == g.capacity());
+        assert(same(g, ref));
+    }
+
+    T* data = g.data();
+    assert(g.gap_position() == g.size());
+    assert(std::equal(data, data + g.size(), ref.begin()));
+
+    g.shrink_to_fit();
+    assert(g.gap_size() == 0 && same(g, ref));
+
+    gap_devector<T> copy(g);
+    assert(same(copy, ref));
+    gap_devector<T> moved(std::move(copy));
+    assert(same(moved, ref) && copy.empty());
+
+    copy = moved;
+    moved.clear();
+    moved = std::move(copy);
+    assert(same(moved, ref));
+}
+
+// A failed copy while moving the gap leaves every element in place.
+void test_exceptions() {
+    gap_devector<throwing> g;
+    std::vector<throwing> ref;
+    for (int i = 0; i < 100; ++i) {
+        g.push_back(i);
+        ref.push_back(i);
+    }
+
+    int thrown = 0;
+    for (int round = 0; round < 200; ++round) {
+        std::size_t pos = rng() % (ref.size() + 1);
+        countdown = 1 + rng() % 60;
+
+        try {
+            g.insert(g.begin() + pos, throwing(-round));
+            countdown = -1;
+            ref.insert(ref.begin() + pos, throwing(-round));
+        } catch (const std::runtime_error&) {
+            ++thrown;
+        }
+
+        countdown = -1;
+        assert(same(g, ref));
+    }
+
+    assert(thrown > 0);
+}
+
+// Allocators with an id, to see which one ends up in the container.
+template<class T, bool Propagate>
+struct id_allocator {
+    typedef T value_type;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_copy_assignment;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_move_assignment;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_swap;
+
+    template<class U> struct rebind { typedef id_allocator<U, Propagate> other; };
+
+    int id;
+
+    explicit id_allocator(int i = 0) : id(i) { }
+    template<class U> id_allocator(const id_allocator<U, Propagate>& other) : id(other.id) { }
+
+    T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    bool operator==(const id_allocator& other) const { return id == other.id; }
+    bool operator!=(const id_allocator& other) const { return id != other.id; }
+};
+
+template<bool Propagate>
+void test_allocator_propagation() {
+    typedef id_allocator<std::string, Propagate> A;
+    gap_devector<std::string, A> a({"a", "b", "c"}, A(1));
+    gap_devector<std::string, A> b(A(2));
+    a.move_gap(1);
+
+    b = a;
+    assert(b.get_allocator().id == (Propagate ? 1 : 2));
+    assert(b.size() == 3 && b[0] == "a" && b[1] == "b" && b[2] == "c");
+
+    gap_devector<std::string, A> c(A(3));
+    c = std::move(b);
+    assert(c.get_allocator().id == (Propagate ? 1 : 3));
+    assert(c.size() == 3 && c[0] == "a" && c[2] == "c");
+
+    // Swapping with unequal allocators that do not propagate is undefined.
+    if (Propagate) {
+        c.swap(a);
+        assert(a.get_allocator().id == 1 && a == c);
+    }
+}
+
+int main() {
+    test_edits<std::string>([](int i) { return std::string(i % 40, char('a' + i % 26)); });
+    test_edits<throwing>([](int i) { return throwing(i); });
+    test_exceptions();
+    test_allocator_propagation<true>();
+    test_allocator_propagation<false>();
+    std::puts("ok");
+}
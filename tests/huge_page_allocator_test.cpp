@@ -0,0 +1,114 @@
+/*
+    Checks huge_page_allocator alignment on the heap and the mapped path, cursor alignment in
+    devector, and that good_size agrees with allocate_at_least. Uses a small threshold so that
+    mapping starts at 64 KiB.
+
+    g++ -std=c++11 -I.. huge_page_allocator_test.cpp -o huge_page_test && ./huge_page_test
+*/
+
+#undef NDEBUG
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "devector.h"
+#include "huge_page_allocator.h"
+
+
+template<std::size_t Alignment>
+bool aligned(const void* p) { return reinterpret_cast<std::uintptr_t>(p) % Alignment == 0; }
+
+huge_page_options small_threshold(bool align_cursor) {
+    huge_page_options opts;
+    opts.threshold = 64 << 10;
+    opts.align_cursor = align_cursor;
+    return opts;
+}
+
+// Heap allocations below the threshold, mapped ones from 64 KiB, for a few sizes around it.
+template<class T, std::size_t Alignment>
+void test_allocate() {
+    huge_page_allocator<T, Alignment> a(small_threshold(false));
+    const std::size_t threshold = (64 << 10) / sizeof(T);
+    const std::size_t sizes[] = {0, 1, 3, 100, threshold - 1, threshold, threshold + 1,
+                                 (4 << 20) / sizeof(T), (4 << 20) / sizeof(T) + 1};
+
+    for (std::size_t n : sizes) {
+        auto mem = a.allocate_at_least(n);
+        assert(aligned<Alignment>(mem.ptr));
+        assert(mem.count >= n && mem.count == a.good_size(n));
+        if (n < threshold) assert(mem.count == n);
+
+        // The whole returned count is usable.
+        if (mem.count) {
+            mem.ptr[0] = T();
+            mem.ptr[mem.count - 1] = T();
+        }
+
+        a.deallocate(mem.ptr, mem.count);
+
+        T* p = a.allocate(n);
+        assert(aligned<Alignment>(p));
+        a.deallocate(p, n);
+    }
+}
+
+// The storage a devector got from its allocator starts this far before data().
+template<class D>
+const void* begin_storage(const D& d) { return d.data() - (d.capacity_front() - d.size()); }
+
+void test_devector_storage() {
+    typedef huge_page_allocator<float, 64> A;
+    devector<float, A> d((A(small_threshold(false))));
+
+    // Heap storage, then mapped storage once it passes 64 KiB.
+    for (int i = 0; i < 100000; ++i) {
+        d.push_back(float(i));
+        if (i % 3 == 0) d.push_front(float(-i));
+        assert(aligned<64>(begin_storage(d)));
+    }
+
+    assert(d.capacity() * sizeof(float) >= (64 << 10));
+}
+
+void test_align_cursor() {
+    typedef huge_page_allocator<float, 64> A;
+    static_assert(64 / sizeof(float) == 16, "");
+    assert(A(small_threshold(true)).cursor_alignment() == 16);
+    assert(A(small_threshold(false)).cursor_alignment() == 1);
+
+    devector<float, A> d((A(small_threshold(true))));
+    for (int i = 0; i < 1000; ++i) d.push_back(float(i));
+
+    // Consume a few at the front, so the first element is no longer aligned.
+    for (int i = 0; i < 3; ++i) d.pop_front();
+    assert(!aligned<64>(d.data()));
+
+    // Mapped, so there is plenty of surplus to round the free space at the front.
+    d.reserve(d.size() + 5, 50000);
+    assert(aligned<64>(d.data()) && d.capacity_front() >= d.size() + 5);
+    assert(d.capacity_back() >= 50000 && d.front() == 3.0f);
+
+    for (int i = 0; i < 3; ++i) d.pop_front();
+    assert(!aligned<64>(d.data()));
+    d.shrink_to_fit();
+    assert(aligned<64>(d.data()) && d.capacity() == d.size() && d.front() == 6.0f);
+
+    // Heap storage on both sides of the shrink.
+    devector<float, A> e((A(small_threshold(true))));
+    for (int i = 0; i < 100; ++i) e.push_back(float(i));
+    e.pop_front();
+    assert(!aligned<64>(e.data()));
+    e.shrink_to_fit();
+    assert(aligned<64>(e.data()) && e.front() == 1.0f && e.back() == 99.0f);
+}
+
+int main() {
+    test_allocate<float, 64>();
+    test_allocate<char, 256>();
+    test_allocate<double, 4096>();
+    test_devector_storage();
+    test_align_cursor();
+    std::puts("ok");
+}
@@ -0,0 +1,189 @@
+/*
+    Checks that reclaim_slack gives memory back without reallocating on every removal or on the
+    next insertion, and that shrink_front and shrink_back release only their own end, also when
+    the allocator rounds allocations up to huge pages.
+
+    g++ -std=c++11 -I.. reclaim_test.cpp -o reclaim_test && ./reclaim_test
+*/
+
+#undef NDEBUG
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include "devector.h"
+#include "huge_page_allocator.h"
+
+
+static_assert(!reclaim_slack<>::should_reclaim<std::size_t>(4, 16), "");
+static_assert(reclaim_slack<>::should_reclaim<std::size_t>(3, 16), "");
+static_assert(!reclaim_slack<>::should_reclaim<std::size_t>(6, 19), "");
+static_assert(reclaim_slack<>::should_reclaim<std::size_t>(4, 19), "");
+static_assert(!reclaim_slack<>::should_reclaim<std::size_t>(0, 15), "");
+static_assert(reclaim_slack<>::should_reclaim(std::size_t(0),
+                                              std::numeric_limits<std::size_t>::max()), "");
+
+
+static std::size_t allocations = 0;
+
+template<class T>
+struct counting_allocator : huge_page_allocator<T> {
+    template<class U> struct rebind { typedef counting_allocator<U> other; };
+
+    counting_allocator() = default;
+    explicit counting_allocator(const huge_page_options& opts) : huge_page_allocator<T>(opts) { }
+
+    template<class U>
+    counting_allocator(const counting_allocator<U>& other)
+    : huge_page_allocator<T>(other.options()) { }
+
+    typename huge_page_allocator<T>::allocation_result allocate_at_least(std::size_t n) {
+        ++allocations;
+        return huge_page_allocator<T>::allocate_at_least(n);
+    }
+
+    T* allocate(std::size_t n) { return allocate_at_least(n).ptr; }
+};
+
+
+void test_huge_pages() {
+    typedef counting_allocator<int> A;
+    huge_page_options opts;
+    opts.threshold = 64 << 10;
+
+    devector<int, A, reclaim_slack<>> d((A(opts)));
+    for (int i = 0; i < 20000; ++i) d.push_back(i);
+
+    // The capacity is a whole huge page, most of it free, but a smaller request rounds up to the
+    // same huge page. Reclaiming would only copy the elements.
+    std::size_t before = allocations;
+    std::size_t capacity = d.capacity();
+    for (int i = 0; i < 1000; ++i) d.pop_back();
+    assert(allocations == before);
+    assert(d.capacity() == capacity);
+
+    // Once the elements fit below the threshold the memory does get reclaimed, a few times.
+    while (d.size() > 100) d.pop_back();
+    assert(allocations - before > 0 && allocations - before < 10);
+    assert(d.capacity() < 1000);
+
+    for (int i = 0; i < 100; ++i) assert(d[i] == i);
+}
+
+void test_std_allocator() {
+    // Without rounding, memory is reclaimed as the devector empties.
+    devector<int, std::allocator<int>, reclaim_slack<>> v;
+    for (int i = 0; i < 20000; ++i) v.push_back(i);
+    std::size_t peak = v.capacity();
+    while (v.size() > 100) v.pop_front();
+    assert(v.capacity() < peak / 16);
+    assert(v.front() == 19900 && v.back() == 19999);
+}
+
+// Draining one end and then growing the other, like a queue, does not reallocate straight after a
+// reclaim. The reclaim leaves free space on the end that was full.
+void test_drain_then_grow() {
+    typedef counting_allocator<int> A;
+    devector<int, A, reclaim_slack<>> d;
+    d.reserve(1000);
+    for (int i = 0; i < 1000; ++i) d.push_back(i);
+
+    std::size_t before = allocations;
+    while (d.size() > 200) d.pop_front();
+    assert(allocations == before + 1);
+    assert(d.capacity_back() - d.size() >= d.size() / 3);
+
+    before = allocations;
+    for (int i = 1000; i < 1000 + 200 / 3; ++i) d.push_back(i);
+    assert(allocations == before);
+    for (std::size_t i = 0; i < d.size(); ++i) assert(d[i] == int(800 + i));
+
+    // The same the other way around.
+    devector<int, A, reclaim_slack<>> e;
+    e.reserve(1000, 0);
+    for (int i = 0; i < 1000; ++i) e.push_front(i);
+
+    while (e.size() > 200) e.pop_back();
+    assert(e.capacity_front() - e.size() >= e.size() / 3);
+
+    before = allocations;
+    for (int i = 1000; i < 1000 + 200 / 3; ++i) e.push_front(i);
+    assert(allocations == before);
+    assert(e.front() == 1000 + 200 / 3 - 1 && e.back() == 800);
+}
+
+// shrink_front and shrink_back release one end and keep the free space at the other.
+void test_shrink_one_end() {
+    devector<std::string> d;
+    d.reserve(100, 200);
+    for (int i = 0; i < 50; ++i) d.push_back(std::to_string(i));
+    for (int i = 0; i < 20; ++i) d.push_front(std::to_string(-i));
+
+    std::size_t free_front = d.capacity_front() - d.size();
+    std::size_t free_back = d.capacity_back() - d.size();
+    assert(free_front > 0 && free_back > 0);
+
+    d.shrink_front();
+    assert(d.capacity_front() == d.size() && d.capacity_back() - d.size() == free_back);
+
+    d.push_front("front");
+    d.pop_front();
+    free_front = d.capacity_front() - d.size();
+    assert(free_front > 0);
+
+    d.shrink_back();
+    assert(d.capacity_back() == d.size() && d.capacity_front() - d.size() == free_front);
+
+    assert(d.size() == 70);
+    for (int i = 0; i < 20; ++i) assert(d[i] == std::to_string(i - 19));
+    for (int i = 0; i < 50; ++i) assert(d[20 + i] == std::to_string(i));
+}
+
+// With mapped storage the allocator unmaps whole huge pages instead of reallocating.
+void test_shrink_in_place() {
+    typedef counting_allocator<int> A;
+    huge_page_options opts;
+    opts.threshold = 64 << 10;
+    const std::size_t page = huge_page_allocator<int>::huge_page_size / sizeof(int);
+
+    devector<int, A> d((A(opts)));
+    for (int i = 0; i < 1000000; ++i) d.push_back(i);
+    assert(d.capacity() == 2 * page);
+
+    std::size_t before = allocations;
+    while (d.size() > 300000) d.pop_back();
+    d.shrink_back();
+    assert(allocations == before);
+    assert(d.capacity() == page && d.capacity_front() == d.size());
+
+    // The elements are moved to the start of the storage, then the rest is unmapped.
+    for (int i = 0; i < 1000000; ++i) d.push_back(300000 + i);
+    while (d.size() > 300000) d.pop_front();
+    std::size_t free_back = d.capacity_back() - d.size();
+    std::size_t pages = (d.size() + free_back + page - 1) / page;
+    assert(pages * page < d.capacity());
+    before = allocations;
+    d.shrink_front();
+    assert(allocations == before);
+    assert(d.capacity() == pages * page && d.capacity_front() == d.size());
+    assert(d.capacity_back() - d.size() >= free_back);
+
+    for (std::size_t i = 0; i < d.size(); ++i) assert(d[i] == int(1000000 + i));
+
+    // Below the threshold the memory has to come from the heap instead.
+    while (d.size() > 1000) d.pop_back();
+    d.shrink_to_fit();
+    assert(allocations == before + 1 && d.capacity() == 1000);
+    for (std::size_t i = 0; i < d.size(); ++i) assert(d[i] == int(1000000 + i));
+}
+
+int main() {
+    test_huge_pages();
+    test_std_allocator();
+    test_drain_then_grow();
+    test_shrink_one_end();
+    test_shrink_in_place();
+    std::puts("ok");
+}